@@ -0,0 +1,30 @@
+#ifndef CANCELLATION_H
+#define CANCELLATION_H
+
+#include <atomic>
+#include <chrono>
+
+// Time at which the threads of one simulation were first asked to stop.
+// The lockstep scheduler stops on its own at the end of the epoch in which the first
+// exit is found; this only records when that was, to measure how long stopping took.
+class CancellationToken {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Request a stop; only the first call records the time
+    void cancel() {
+        bool expected = false;
+        if (claimed.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            cancelTime = Clock::now();
+        }
+    }
+
+    // Time of the first cancel(); only meaningful once the workers have joined
+    Clock::time_point getCancelTime() const { return cancelTime; }
+
+private:
+    std::atomic<bool> claimed{false};
+    Clock::time_point cancelTime;
+};
+
+#endif // CANCELLATION_H
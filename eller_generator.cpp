@@ -0,0 +1,141 @@
+#include "eller_generator.h"
+#include "maze.h"
+#include "maze_lattice.h"
+#include <algorithm>
+
+EllerGenerator::EllerGenerator(int width, int height, int startX, int startY, int exitX, int exitY, std::uint64_t seed)
+    : width(width), height(height), startX(startX), startY(startY), exitX(exitX), exitY(exitY),
+      columns(latticeCells(width)), rows(latticeCells(height)),
+      rng(RandomStream::XOSHIRO, seed), bits(0), bitsLeft(0),
+      parent(columns), right(columns), down(columns), lastMember(columns), firstDown(columns), setOf(columns), row(width) { }
+
+int EllerGenerator::find(int cell) {
+    while (parent[cell] != cell) {
+        parent[cell] = parent[parent[cell]];
+        cell = parent[cell];
+    }
+    return cell;
+}
+
+bool EllerGenerator::coin() {
+    if (bitsLeft == 0) {
+        bits = rng.next();
+        bitsLeft = 32;
+    }
+    bool bit = bits & 1;
+    bits >>= 1;
+    --bitsLeft;
+    return bit;
+}
+
+bool EllerGenerator::generate(MazeRowSink& sink) {
+    if (!sink.begin(width, height)) {
+        return false;
+    }
+
+    // Every cell of the first row starts in its own set
+    for (int c = 0; c < columns; ++c) {
+        parent[c] = c;
+    }
+
+    int y = 0;
+    for (int r = 0; r < rows; ++r) {
+        bool lastRow = r == rows - 1;
+
+        // Randomly join neighbours from different sets; the last row joins all of them
+        for (int c = 0; c < columns; ++c) {
+            right[c] = 0;
+            if (c + 1 < columns) {
+                int a = find(c), b = find(c + 1);
+                if (a != b && (lastRow || coin())) {
+                    parent[b] = a;
+                    right[c] = 1;
+                }
+            }
+        }
+
+        // Every set opens downwards at least once
+        for (int c = 0; c < columns; ++c) {
+            lastMember[find(c)] = c;
+            firstDown[c] = -1;
+        }
+        for (int c = 0; c < columns; ++c) {
+            int set = find(c);
+            down[c] = 0;
+            if (!lastRow && (coin() || (lastMember[set] == c && firstDown[set] < 0))) {
+                down[c] = 1;
+                if (firstDown[set] < 0) {
+                    firstDown[set] = c;
+                }
+            }
+        }
+
+        // Emit the grid rows above this lattice row and the row itself with its down openings
+        for (; y <= 2 * r + 2; ++y) {
+            if (!emitRow(sink, y)) {
+                return false;
+            }
+        }
+
+        // Cells opened from above keep their set, the others start new ones
+        for (int c = 0; c < columns; ++c) {
+            setOf[c] = find(c);
+        }
+        for (int c = 0; c < columns; ++c) {
+            parent[c] = down[c] ? firstDown[setOf[c]] : c;
+        }
+    }
+
+    // Remaining rows are border or the wall row left by an even height
+    for (; y < height; ++y) {
+        if (!emitRow(sink, y)) {
+            return false;
+        }
+    }
+    return sink.end();
+}
+
+bool EllerGenerator::emitRow(MazeRowSink& sink, int y) {
+    std::fill(row.begin(), row.end(), static_cast<std::uint8_t>(Maze::WALL));
+
+    int r = (y - 1) / 2;
+    if (y > 0 && r < rows) {
+        if (y % 2 == 1) {
+            // Lattice row: cells and the openings to their right
+            for (int c = 0; c < columns; ++c) {
+                row[2 * c + 1] = Maze::PATH;
+                if (right[c]) {
+                    row[2 * c + 2] = Maze::PATH;
+                }
+            }
+        } else {
+            // Row between two lattice rows: openings down
+            for (int c = 0; c < columns; ++c) {
+                if (down[c]) {
+                    row[2 * c + 1] = Maze::PATH;
+                }
+            }
+        }
+    }
+
+    // Start and exit, with the corridors joining them to the lattice
+    const int endpoints[2][2] = { { startX, startY }, { exitX, exitY } };
+    for (const auto& point : endpoints) {
+        int oy = nearestLatticeCoordinate(point[1], height);
+        // Rows from the point to its lattice row
+        if (std::min(point[1], oy) <= y && y <= std::max(point[1], oy)) {
+            for (int x = 0; x < width; ++x) {
+                if (onLatticeConnector(point[0], point[1], x, y, width, height)) {
+                    row[x] = Maze::PATH;
+                }
+            }
+        }
+    }
+    if (y == startY) {
+        row[startX] = Maze::START;
+    }
+    if (y == exitY) {
+        row[exitX] = Maze::EXIT;
+    }
+    return sink.writeRow(row.data());
+}
@@ -0,0 +1,43 @@
+#ifndef ELLER_GENERATOR_H
+#define ELLER_GENERATOR_H
+
+#include <cstdint>
+#include <vector>
+#include "maze_stream.h"
+#include "rng.h"
+
+// Perfect-maze generator using Eller's algorithm. The maze is produced one lattice row at a
+// time and streamed to a MazeRowSink, so memory stays O(width) for any height.
+class EllerGenerator {
+public:
+    EllerGenerator(int width, int height, int startX, int startY, int exitX, int exitY, std::uint64_t seed);
+
+    bool generate(MazeRowSink& sink);
+
+private:
+    // Representative of a cell's set within the current lattice row
+    int find(int cell);
+
+    // Random bit from the generator's stream
+    bool coin();
+
+    // Write grid row y given the state of the current lattice row
+    bool emitRow(MazeRowSink& sink, int y);
+
+    int width, height;
+    int startX, startY, exitX, exitY;
+    int columns, rows;               // Lattice size
+    RandomStream rng;
+    std::uint32_t bits;
+    int bitsLeft;
+
+    std::vector<int> parent;         // Union-find over the cells of the current lattice row
+    std::vector<std::uint8_t> right; // Opening to the right of each cell
+    std::vector<std::uint8_t> down;  // Opening below each cell
+    std::vector<int> lastMember;     // Per set: rightmost member in the row
+    std::vector<int> firstDown;      // Per set: leftmost member opening down
+    std::vector<int> setOf;          // Set of each cell when moving to the next row
+    std::vector<std::uint8_t> row;   // One grid row of cell types
+};
+
+#endif // ELLER_GENERATOR_H
@@ -0,0 +1,426 @@
+#include "image_writer.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <zlib.h>
+
+namespace {
+
+const size_t STRIP_BYTES = 1 << 20;  // Converted bytes per strip of rows
+const int BATCH_STRIPS = 64;         // Strips converted in parallel before they are written
+const int PNG_COMPRESSION = 6;       // zlib level; maze images compress well at any level
+
+// Rows per strip for rows of the given size
+int stripRows(size_t rowBytes) {
+    return static_cast<int>(std::max<size_t>(1, STRIP_BYTES / rowBytes));
+}
+
+bool hasExtension(const std::string& filename, const std::string& extension) {
+    return filename.size() >= extension.size() &&
+           filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+// Convert rows [0, height) of rowBytes each with convertRow(y, out) and write them in order.
+// Batches of strips are converted in parallel into preallocated buffers.
+template <typename ConvertRow>
+bool writeRows(std::FILE* file, int height, size_t rowBytes, ConvertRow convertRow) {
+    const int rows = stripRows(rowBytes);
+    const int strips = (height + rows - 1) / rows;
+    std::vector<std::vector<std::uint8_t>> buffers(std::min(strips, BATCH_STRIPS));
+    for (auto& buffer : buffers) {
+        buffer.resize(rowBytes * rows);
+    }
+
+    for (int firstStrip = 0; firstStrip < strips; firstStrip += BATCH_STRIPS) {
+        const int batch = std::min(BATCH_STRIPS, strips - firstStrip);
+
+#pragma omp parallel for schedule(static)
+        for (int i = 0; i < batch; ++i) {
+            int firstRow = (firstStrip + i) * rows;
+            int lastRow = std::min(height, firstRow + rows);
+            for (int y = firstRow; y < lastRow; ++y) {
+                convertRow(y, buffers[i].data() + (y - firstRow) * rowBytes);
+            }
+        }
+
+        for (int i = 0; i < batch; ++i) {
+            int firstRow = (firstStrip + i) * rows;
+            size_t bytes = (std::min(height, firstRow + rows) - firstRow) * rowBytes;
+            if (std::fwrite(buffers[i].data(), 1, bytes, file) != bytes) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void putLittle16(std::uint8_t* out, std::uint32_t value) {
+    out[0] = static_cast<std::uint8_t>(value);
+    out[1] = static_cast<std::uint8_t>(value >> 8);
+}
+
+void putLittle32(std::uint8_t* out, std::uint32_t value) {
+    putLittle16(out, value);
+    putLittle16(out + 2, value >> 16);
+}
+
+void putBig32(std::uint8_t* out, std::uint32_t value) {
+    out[0] = static_cast<std::uint8_t>(value >> 24);
+    out[1] = static_cast<std::uint8_t>(value >> 16);
+    out[2] = static_cast<std::uint8_t>(value >> 8);
+    out[3] = static_cast<std::uint8_t>(value);
+}
+
+bool writePpm(std::FILE* file, const Framebuffer& frame) {
+    const int width = frame.getWidth();
+    if (std::fprintf(file, "P6\n%d %d\n255\n", width, frame.getHeight()) < 0) {
+        return false;
+    }
+    return writeRows(file, frame.getHeight(), 3 * static_cast<size_t>(width), [&](int y, std::uint8_t* out) {
+        const Rgba* pixels = frame.row(y);
+        for (int x = 0; x < width; ++x) {
+            out[3 * x] = pixels[x].r;
+            out[3 * x + 1] = pixels[x].g;
+            out[3 * x + 2] = pixels[x].b;
+        }
+    });
+}
+
+bool writePgm(std::FILE* file, const Framebuffer& frame) {
+    const int width = frame.getWidth();
+    if (std::fprintf(file, "P5\n%d %d\n255\n", width, frame.getHeight()) < 0) {
+        return false;
+    }
+    return writeRows(file, frame.getHeight(), static_cast<size_t>(width), [&](int y, std::uint8_t* out) {
+        const Rgba* pixels = frame.row(y);
+        for (int x = 0; x < width; ++x) {
+            // Rec. 601 luma in 8-bit fixed point
+            out[x] = static_cast<std::uint8_t>((77 * pixels[x].r + 150 * pixels[x].g + 29 * pixels[x].b + 128) >> 8);
+        }
+    });
+}
+
+bool writeBmp(std::FILE* file, const Framebuffer& frame) {
+    const int width = frame.getWidth();
+    const int height = frame.getHeight();
+    const size_t rowBytes = (3 * static_cast<size_t>(width) + 3) & ~static_cast<size_t>(3);
+    const std::uint64_t imageBytes = static_cast<std::uint64_t>(rowBytes) * height;
+    if (imageBytes + 54 > UINT32_MAX) {
+        std::cerr << "Image too large for BMP: " << width << "x" << height << std::endl;
+        return false;
+    }
+
+    std::uint8_t header[54] = {};
+    header[0] = 'B';
+    header[1] = 'M';
+    putLittle32(header + 2, static_cast<std::uint32_t>(imageBytes + 54));  // File size
+    putLittle32(header + 10, 54);                                          // Pixel data offset
+    putLittle32(header + 14, 40);                                          // Info header size
+    putLittle32(header + 18, static_cast<std::uint32_t>(width));
+    putLittle32(header + 22, static_cast<std::uint32_t>(height));           // Positive: bottom-up
+    putLittle16(header + 26, 1);                                           // Planes
+    putLittle16(header + 28, 24);                                          // Bits per pixel
+    putLittle32(header + 34, static_cast<std::uint32_t>(imageBytes));
+    putLittle32(header + 38, 2835);                                        // 72 dpi
+    putLittle32(header + 42, 2835);
+    if (std::fwrite(header, sizeof(header), 1, file) != 1) {
+        return false;
+    }
+
+    return writeRows(file, height, rowBytes, [&](int y, std::uint8_t* out) {
+        const Rgba* pixels = frame.row(height - 1 - y);
+        for (int x = 0; x < width; ++x) {
+            out[3 * x] = pixels[x].b;
+            out[3 * x + 1] = pixels[x].g;
+            out[3 * x + 2] = pixels[x].r;
+        }
+        std::memset(out + 3 * static_cast<size_t>(width), 0, rowBytes - 3 * static_cast<size_t>(width));
+    });
+}
+
+std::uint32_t packColor(Rgba color) {
+    std::uint32_t value;
+    std::memcpy(&value, &color, sizeof(value));
+    return value;
+}
+
+Rgba unpackColor(std::uint32_t value) {
+    Rgba color;
+    std::memcpy(&color, &value, sizeof(color));
+    return color;
+}
+
+// Distinct colours of the image in increasing order, or an empty palette if there are more
+// than 256. Sets opaque when no pixel has any transparency.
+std::vector<std::uint32_t> findPalette(const Framebuffer& frame, bool& opaque) {
+    const int width = frame.getWidth();
+    const int height = frame.getHeight();
+    const int rows = stripRows(static_cast<size_t>(width) * sizeof(Rgba));
+    const int strips = (height + rows - 1) / rows;
+    std::vector<std::unordered_set<std::uint32_t>> found(strips);
+    std::atomic<bool> overflow{false};
+    std::atomic<bool> translucent{false};
+
+#pragma omp parallel for schedule(static)
+    for (int s = 0; s < strips; ++s) {
+        std::uint32_t last = packColor(frame.row(s * rows)[0]);
+        found[s].insert(last);
+        for (int y = s * rows; y < std::min(height, (s + 1) * rows); ++y) {
+            const Rgba* pixels = frame.row(y);
+            for (int x = 0; x < width; ++x) {
+                if (pixels[x].a != 255) {
+                    translucent.store(true, std::memory_order_relaxed);
+                }
+                std::uint32_t color = packColor(pixels[x]);
+                if (color != last && !overflow.load(std::memory_order_relaxed)) {
+                    last = color;
+                    found[s].insert(color);
+                    if (found[s].size() > 256) {
+                        overflow.store(true, std::memory_order_relaxed);
+                    }
+                }
+            }
+        }
+    }
+    opaque = !translucent;
+
+    std::unordered_set<std::uint32_t> colors;
+    for (const auto& strip : found) {
+        colors.insert(strip.begin(), strip.end());
+        if (overflow || colors.size() > 256) {
+            return {};
+        }
+    }
+    std::vector<std::uint32_t> palette(colors.begin(), colors.end());
+    std::sort(palette.begin(), palette.end());
+    return palette;
+}
+
+bool writeChunk(std::FILE* file, const char* type, const std::uint8_t* data, size_t size) {
+    std::uint8_t length[4];
+    putBig32(length, static_cast<std::uint32_t>(size));
+    uLong crc = crc32(0, reinterpret_cast<const Bytef*>(type), 4);
+    if (size > 0) {
+        crc = crc32(crc, data, static_cast<uInt>(size));  // A null buffer would reset the CRC
+    }
+    std::uint8_t check[4];
+    putBig32(check, static_cast<std::uint32_t>(crc));
+    return std::fwrite(length, 4, 1, file) == 1 && std::fwrite(type, 4, 1, file) == 1 &&
+           (size == 0 || std::fwrite(data, size, 1, file) == 1) && std::fwrite(check, 4, 1, file) == 1;
+}
+
+// Compress one strip as raw deflate blocks. Every strip but the last ends on a byte boundary
+// with a sync flush, so the strips can be concatenated into one deflate stream.
+bool deflateStrip(const std::vector<std::uint8_t>& raw, bool last, std::vector<std::uint8_t>& out) {
+    z_stream stream = {};
+    if (deflateInit2(&stream, PNG_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    out.resize(deflateBound(&stream, raw.size()) + 64);  // Room for the flush marker
+    stream.next_in = const_cast<Bytef*>(raw.data());
+    stream.avail_in = static_cast<uInt>(raw.size());
+    stream.next_out = out.data();
+    stream.avail_out = static_cast<uInt>(out.size());
+    int result = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+    bool ok = last ? result == Z_STREAM_END : result == Z_OK && stream.avail_in == 0 && stream.avail_out != 0;
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return ok;
+}
+
+bool writePng(std::FILE* file, const Framebuffer& frame) {
+    const int width = frame.getWidth();
+    const int height = frame.getHeight();
+    bool opaque;
+    std::vector<std::uint32_t> palette = findPalette(frame, opaque);
+
+    // Indexed colour packs 1, 2, 4 or 8 bits per pixel; truecolour stores 3 or 4 bytes
+    const bool indexed = !palette.empty();
+    int depth = 8;
+    if (indexed) {
+        depth = palette.size() <= 2 ? 1 : palette.size() <= 4 ? 2 : palette.size() <= 16 ? 4 : 8;
+    }
+    const int channels = indexed ? 1 : opaque ? 3 : 4;
+    const size_t pixelBytes = (static_cast<size_t>(width) * channels * depth + 7) / 8;
+    const size_t rowBytes = pixelBytes + 1;  // Leading filter type
+    if (rowBytes > (1u << 30)) {
+        std::cerr << "Image too wide for PNG: " << width << std::endl;
+        return false;
+    }
+
+    std::unordered_map<std::uint32_t, std::uint8_t> indices;
+    for (size_t i = 0; i < palette.size(); ++i) {
+        indices[palette[i]] = static_cast<std::uint8_t>(i);
+    }
+
+    static const std::uint8_t SIGNATURE[8] = { 137, 'P', 'N', 'G', '\r', '\n', 26, '\n' };
+    std::uint8_t header[13];
+    putBig32(header, static_cast<std::uint32_t>(width));
+    putBig32(header + 4, static_cast<std::uint32_t>(height));
+    header[8] = static_cast<std::uint8_t>(depth);
+    header[9] = indexed ? 3 : opaque ? 2 : 6;  // Colour type
+    header[10] = 0;                            // Deflate
+    header[11] = 0;                            // Adaptive filtering
+    header[12] = 0;                            // No interlacing
+    if (std::fwrite(SIGNATURE, sizeof(SIGNATURE), 1, file) != 1 || !writeChunk(file, "IHDR", header, sizeof(header))) {
+        return false;
+    }
+
+    if (indexed) {
+        std::vector<std::uint8_t> colors, alphas;
+        for (std::uint32_t value : palette) {
+            Rgba color = unpackColor(value);
+            colors.insert(colors.end(), { color.r, color.g, color.b });
+            alphas.push_back(color.a);
+        }
+        if (!writeChunk(file, "PLTE", colors.data(), colors.size())) {
+            return false;
+        }
+        if (!opaque && !writeChunk(file, "tRNS", alphas.data(), alphas.size())) {
+            return false;
+        }
+    }
+
+    // Unfiltered bytes of one row
+    auto convertRow = [&](int y, std::uint8_t* out) {
+        const Rgba* pixels = frame.row(y);
+        if (!indexed) {
+            for (int x = 0; x < width; ++x) {
+                std::memcpy(out + static_cast<size_t>(x) * channels, &pixels[x], channels);
+            }
+            return;
+        }
+        std::memset(out, 0, pixelBytes);
+        std::uint32_t lastColor = packColor(pixels[0]);
+        int lastIndex = indices.find(lastColor)->second;
+        for (int x = 0; x < width; ++x) {
+            std::uint32_t color = packColor(pixels[x]);
+            if (color != lastColor) {
+                lastColor = color;
+                lastIndex = indices.find(color)->second;
+            }
+            // The leftmost pixel sits in the high-order bits
+            size_t bit = static_cast<size_t>(x) * depth;
+            out[bit / 8] |= static_cast<std::uint8_t>(lastIndex << (8 - depth - bit % 8));
+        }
+    };
+
+    // The zlib stream is its header, the deflated strips, and the Adler-32 of all the rows
+    const std::uint8_t zlibHeader[2] = { 0x78, 0x9C };
+    if (!writeChunk(file, "IDAT", zlibHeader, sizeof(zlibHeader))) {
+        return false;
+    }
+
+    const int rows = stripRows(rowBytes);
+    const int strips = (height + rows - 1) / rows;
+    const int batchSize = std::min(strips, BATCH_STRIPS);
+    std::vector<std::vector<std::uint8_t>> raw(batchSize), compressed(batchSize);
+    std::vector<uLong> adlers(batchSize);
+    uLong adler = adler32(0, Z_NULL, 0);
+
+    for (int firstStrip = 0; firstStrip < strips; firstStrip += BATCH_STRIPS) {
+        const int batch = std::min(BATCH_STRIPS, strips - firstStrip);
+        std::atomic<bool> ok{true};
+
+#pragma omp parallel for schedule(static)
+        for (int i = 0; i < batch; ++i) {
+            int firstRow = (firstStrip + i) * rows;
+            int lastRow = std::min(height, firstRow + rows);
+            std::vector<std::uint8_t>& bytes = raw[i];
+            bytes.resize((lastRow - firstRow) * rowBytes);
+
+            // Truecolour rows use the Up filter, which turns the repeated rows of a cell into zeros;
+            // indexed rows are left unfiltered as the PNG specification recommends
+            std::vector<std::uint8_t> previous(indexed || firstRow == 0 ? 0 : pixelBytes);
+            if (!previous.empty()) {
+                convertRow(firstRow - 1, previous.data());
+            }
+            std::vector<std::uint8_t> current(pixelBytes);
+            for (int y = firstRow; y < lastRow; ++y) {
+                std::uint8_t* out = bytes.data() + (y - firstRow) * rowBytes;
+                convertRow(y, current.data());
+                if (previous.empty()) {
+                    out[0] = 0;
+                    std::memcpy(out + 1, current.data(), pixelBytes);
+                    if (!indexed) {
+                        previous = current;
+                    }
+                } else {
+                    out[0] = 2;
+                    for (size_t b = 0; b < pixelBytes; ++b) {
+                        out[1 + b] = static_cast<std::uint8_t>(current[b] - previous[b]);
+                    }
+                    previous.swap(current);
+                }
+            }
+
+            adlers[i] = adler32(adler32(0, Z_NULL, 0), bytes.data(), static_cast<uInt>(bytes.size()));
+            if (!deflateStrip(bytes, firstStrip + i == strips - 1, compressed[i])) {
+                ok = false;
+            }
+        }
+
+        if (!ok) {
+            std::cerr << "Error compressing image data" << std::endl;
+            return false;
+        }
+        for (int i = 0; i < batch; ++i) {
+            adler = adler32_combine(adler, adlers[i], static_cast<z_off_t>(raw[i].size()));
+            if (!writeChunk(file, "IDAT", compressed[i].data(), compressed[i].size())) {
+                return false;
+            }
+        }
+    }
+
+    std::uint8_t trailer[4];
+    putBig32(trailer, static_cast<std::uint32_t>(adler));
+    return writeChunk(file, "IDAT", trailer, sizeof(trailer)) && writeChunk(file, "IEND", nullptr, 0);
+}
+
+} // namespace
+
+bool imageFormatOf(const std::string& filename, ImageFormat& format) {
+    if (hasExtension(filename, ".png")) {
+        format = ImageFormat::PNG;
+    } else if (hasExtension(filename, ".ppm")) {
+        format = ImageFormat::PPM;
+    } else if (hasExtension(filename, ".pgm")) {
+        format = ImageFormat::PGM;
+    } else if (hasExtension(filename, ".bmp")) {
+        format = ImageFormat::BMP;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool writeImage(const Framebuffer& frame, const std::string& filename, ImageFormat format) {
+    if (frame.getWidth() <= 0 || frame.getHeight() <= 0) {
+        std::cerr << "Cannot write an empty image: " << filename << std::endl;
+        return false;
+    }
+    std::FILE* file = std::fopen(filename.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Unable to open file for writing: " << filename << std::endl;
+        return false;
+    }
+
+    bool ok = false;
+    switch (format) {
+        case ImageFormat::PNG: ok = writePng(file, frame); break;
+        case ImageFormat::PPM: ok = writePpm(file, frame); break;
+        case ImageFormat::PGM: ok = writePgm(file, frame); break;
+        case ImageFormat::BMP: ok = writeBmp(file, frame); break;
+    }
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Error writing image file: " << filename << std::endl;
+    }
+    return ok;
+}
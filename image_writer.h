@@ -0,0 +1,24 @@
+#ifndef IMAGE_WRITER_H
+#define IMAGE_WRITER_H
+
+#include <string>
+#include "maze_image.h"
+
+// Image file formats written without any graphics library
+enum class ImageFormat {
+    PNG,  // Indexed colour when the image has at most 256 colours, RGB or RGBA otherwise
+    PPM,  // Binary RGB (P6)
+    PGM,  // Binary grey levels (P5), from the luminance of each pixel
+    BMP   // Uncompressed 24-bit, bottom-up rows
+};
+
+// Format for the extension of a file name (case-sensitive: .png, .ppm, .pgm, .bmp);
+// returns false for any other extension
+bool imageFormatOf(const std::string& filename, ImageFormat& format);
+
+// Write the pixels in the given format; reports problems on std::cerr.
+// Rows are converted in parallel strips and leave in large sequential writes. PNG strips are
+// deflated independently and joined into one zlib stream, so compression uses every core.
+bool writeImage(const Framebuffer& frame, const std::string& filename, ImageFormat format);
+
+#endif // IMAGE_WRITER_H
@@ -0,0 +1,29 @@
+#include "implicit_maze.h"
+#include "maze_lattice.h"
+#include <vector>
+
+ImplicitMaze::ImplicitMaze(int width, int height, int startX, int startY, int exitX, int exitY,
+                           std::uint64_t seed, Rule rule)
+    : width(width), height(height),
+      startX(startX), startY(startY), exitX(exitX), exitY(exitY),
+      seed(seed), rule(rule),
+      columns(latticeCells(width)), rows(latticeCells(height)),
+      connectors{
+          { startX, startY, nearestLatticeCoordinate(startX, width), nearestLatticeCoordinate(startY, height) },
+          { exitX, exitY, nearestLatticeCoordinate(exitX, width), nearestLatticeCoordinate(exitY, height) } } { }
+
+bool ImplicitMaze::generate(MazeRowSink& sink) const {
+    if (!sink.begin(width, height)) {
+        return false;
+    }
+    std::vector<std::uint8_t> row(width);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            row[x] = (*this)(x, y);
+        }
+        if (!sink.writeRow(row.data())) {
+            return false;
+        }
+    }
+    return sink.end();
+}
@@ -0,0 +1,143 @@
+#ifndef IMPLICIT_MAZE_H
+#define IMPLICIT_MAZE_H
+
+#include <cstdint>
+#include "maze.h"
+#include "maze_stream.h"
+#include "rng.h"
+#include "walk.h"
+
+// Maze whose cells are never stored: the type of any cell is computed on demand from the seed
+// and its coordinates, so mazes far larger than memory (10^6 x 10^6 and up) can be walked.
+// Lattice cells at odd coordinates are joined by a perfect-maze rule that each cell can
+// decide locally, and cells are queried the same way as through Maze::getData.
+class ImplicitMaze {
+public:
+    enum Rule {
+        BINARY_TREE,  // Every cell opens up or left
+        SIDEWINDER    // Runs of at most MAX_RUN cells along a row, each opened upwards once
+    };
+
+    // Longest sidewinder run, which bounds the work of a lookup
+    static constexpr int MAX_RUN = 16;
+
+    ImplicitMaze(int width, int height, int startX, int startY, int exitX, int exitY,
+                 std::uint64_t seed, Rule rule = SIDEWINDER);
+
+    // Cell type at (x, y); everything outside the maze is a wall
+    std::uint8_t operator()(int x, int y) const;
+
+    // Open-neighbour mask at (x, y) (see walk.h for the direction order)
+    std::uint8_t openMask(int x, int y) const;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    std::uint64_t getSeed() const { return seed; }
+
+    // Compute every row and hand it to a sink, e.g. to materialize the maze as a text file
+    bool generate(MazeRowSink& sink) const;
+
+private:
+    // Random bits of a lattice cell
+    std::uint64_t hash(int cx, int cy) const {
+        return splitMix64(seed ^ splitMix64((static_cast<std::uint64_t>(cy) << 32) | static_cast<std::uint32_t>(cx)));
+    }
+
+    // Sidewinder run ends at lattice cell (cx, cy)
+    bool closesRun(int cx, int cy) const {
+        return cx + 1 == columns || (cx + 1) % MAX_RUN == 0 || (hash(cx, cy) & 1) == 0;
+    }
+
+    // Passage between lattice cells (cx, cy) and (cx + 1, cy)
+    bool rightOpen(int cx, int cy) const;
+
+    // Passage between lattice cells (cx, cy) and (cx, cy + 1)
+    bool downOpen(int cx, int cy) const;
+
+    // True if (x, y) is on the corridor joining the start or exit to the lattice
+    bool onConnector(int x, int y) const;
+
+    int width, height;
+    int startX, startY, exitX, exitY;
+    std::uint64_t seed;
+    Rule rule;
+    int columns, rows;    // Lattice size
+    int connectors[2][4]; // Start and exit with their nearest lattice cell: px, py, ox, oy
+};
+
+inline bool ImplicitMaze::rightOpen(int cx, int cy) const {
+    if (cy == 0) {
+        return true;  // Both rules run the top row as one corridor
+    }
+    if (rule == BINARY_TREE) {
+        return (hash(cx + 1, cy) & 1) == 0;  // The right cell opens left
+    }
+    return !closesRun(cx, cy);
+}
+
+inline bool ImplicitMaze::downOpen(int cx, int cy) const {
+    if (rule == BINARY_TREE) {
+        return cx == 0 || (hash(cx, cy + 1) & 1) == 1;  // The lower cell opens up
+    }
+
+    // Find the run of the lower cell; it opens upwards at one cell picked by its first cell
+    int row = cy + 1;
+    int first = cx;
+    while (first > 0 && !closesRun(first - 1, row)) {
+        --first;
+    }
+    int last = cx;
+    while (!closesRun(last, row)) {
+        ++last;
+    }
+    return first + static_cast<int>((hash(first, row) >> 32) % static_cast<std::uint64_t>(last - first + 1)) == cx;
+}
+
+inline bool ImplicitMaze::onConnector(int x, int y) const {
+    for (const auto& c : connectors) {
+        if (y == c[1] && ((x >= c[2] && x <= c[0]) || (x <= c[2] && x >= c[0]))) {
+            return true;
+        }
+        if (x == c[2] && ((y >= c[3] && y <= c[1]) || (y <= c[3] && y >= c[1]))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline std::uint8_t ImplicitMaze::operator()(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) {
+        return Maze::WALL;
+    }
+    if (x == exitX && y == exitY) {
+        return Maze::EXIT;
+    }
+    if (x == startX && y == startY) {
+        return Maze::START;
+    }
+    if (onConnector(x, y)) {
+        return Maze::PATH;
+    }
+
+    // Beyond the lattice, and at even-even posts, there are only walls
+    if (x > 2 * columns - 1 || y > 2 * rows - 1 || ((x | y) & 1) == 0) {
+        return Maze::WALL;
+    }
+    if (x & y & 1) {
+        return Maze::PATH;
+    }
+    bool open = (x & 1) ? y > 0 && downOpen(x / 2, y / 2 - 1) : x > 0 && rightOpen(x / 2 - 1, y / 2);
+    return open ? Maze::PATH : Maze::WALL;
+}
+
+inline std::uint8_t ImplicitMaze::openMask(int x, int y) const {
+    int mask = 0;
+    for (int dir = 0; dir < 4; ++dir) {
+        if ((*this)(x + DIRECTION_DX[dir], y + DIRECTION_DY[dir]) != Maze::WALL) {
+            mask |= 1 << dir;
+        }
+    }
+    return static_cast<std::uint8_t>(mask);
+}
+
+#endif // IMPLICIT_MAZE_H
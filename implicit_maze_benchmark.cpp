@@ -0,0 +1,90 @@
+#include "maze.h"
+#include "implicit_maze.h"
+#include "particle.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <iomanip>
+#include <fstream>
+
+// Move every particle `steps` times; returns the elapsed time in seconds
+template <typename Grid>
+double walk(const Grid& maze, std::vector<Particle>& particles, int steps, WalkMode mode) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (auto& particle : particles) {
+        for (int step = 0; step < steps; ++step) {
+            particle.move(maze, mode);
+        }
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = endTime - startTime;
+    return elapsed.count();
+}
+
+std::vector<Particle> makeParticles(int count, std::uint64_t seed) {
+    std::vector<Particle> particles;
+    for (int i = 0; i < count; ++i) {
+        particles.emplace_back(1, 1, RandomStream(RandomStream::PHILOX, seed, static_cast<std::uint32_t>(i)));
+    }
+    return particles;
+}
+
+int main() {
+    const int materializedSize = 2001;   // Walked both stored and implicit
+    const int implicitSize = 1000001;    // Walked implicitly only; never fits a stored grid comfortably
+    const int particleCount = 100;
+    const int steps = 100000;            // Moves per particle
+    const std::uint64_t seed = 12345;
+    const ImplicitMaze::Rule rules[2] = { ImplicitMaze::BINARY_TREE, ImplicitMaze::SIDEWINDER };
+    const char* ruleNames[2] = { "binary-tree", "sidewinder" };
+    const WalkMode modes[2] = { WalkMode::LAZY, WalkMode::LEGAL };
+    const char* modeNames[2] = { "lazy", "legal" };
+
+    std::ofstream csvFile("../output/implicit_maze_times.csv");
+    csvFile << "Rule,Size,Walk,Backend,Time (seconds),Moves per second\n" << std::fixed;
+
+    auto report = [&](const char* rule, int size, const char* mode, const char* backend, double seconds) {
+        double movesPerSecond = static_cast<double>(particleCount) * steps / seconds;
+        std::cout << rule << " " << size << "x" << size << " " << mode << " " << backend << ": "
+                  << std::fixed << std::setprecision(4) << seconds << " seconds, "
+                  << std::setprecision(0) << movesPerSecond << " moves/second" << std::endl;
+        csvFile << rule << "," << size << "," << mode << "," << backend << ","
+                << std::setprecision(6) << seconds << "," << std::setprecision(0) << movesPerSecond << "\n";
+    };
+
+    for (int r = 0; r < 2; ++r) {
+        // Materialize the implicit maze through the text format so both backends walk the same cells
+        ImplicitMaze implicit(materializedSize, materializedSize, 1, 1, materializedSize - 2, materializedSize - 2, seed, rules[r]);
+        std::string filename = std::string("implicit_") + ruleNames[r] + "_" + std::to_string(materializedSize) + ".txt";
+        TextRowSink sink("../input/" + filename);
+        Maze maze;
+        if (!implicit.generate(sink) || !maze.loadFromFile(filename)) {
+            std::cerr << "Failed to materialize implicit maze: " << filename << std::endl;
+            continue;
+        }
+
+        ImplicitMaze huge(implicitSize, implicitSize, 1, 1, implicitSize - 2, implicitSize - 2, seed, rules[r]);
+
+        for (int m = 0; m < 2; ++m) {
+            std::vector<Particle> stored = makeParticles(particleCount, seed);
+            std::vector<Particle> computed = makeParticles(particleCount, seed);
+            report(ruleNames[r], materializedSize, modeNames[m], "grid", walk(maze.getData(), stored, steps, modes[m]));
+            report(ruleNames[r], materializedSize, modeNames[m], "implicit", walk(implicit, computed, steps, modes[m]));
+
+            // Same cells and same streams must give the same walks
+            for (int i = 0; i < particleCount; ++i) {
+                if (stored[i].getX() != computed[i].getX() || stored[i].getY() != computed[i].getY()) {
+                    std::cerr << "Implicit and stored walks differ for particle " << i << std::endl;
+                    break;
+                }
+            }
+
+            std::vector<Particle> far = makeParticles(particleCount, seed);
+            report(ruleNames[r], implicitSize, modeNames[m], "implicit", walk(huge, far, steps, modes[m]));
+        }
+    }
+
+    csvFile.close();
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include "lockstep_scheduler.h"
+#include "cancellation.h"
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+LockstepScheduler::LockstepScheduler(int quantum, int threads)
+    : quantum(quantum), threads(threads), stopLatency(0) { }
+
+ExitEvent LockstepScheduler::run(ParticleSwarm& swarm) {
+    const int count = swarm.size();
+    if (count == 0) {
+        // No blocks would ever report an arrival, so the epochs would never end
+        stopLatency = 0;
+        return ExitEvent{};
+    }
+
+    // Blocks are multiples of the widest SIMD vector so every thread can use whole vectors
+    int block = (count + threads - 1) / threads;
+    block = std::min(MAX_BLOCK, std::max(16, (block + 15) / 16 * 16));
+    const int blocks = (count + block - 1) / block;
+
+    CancellationToken token;                                // Marks the first arrival for timing
+    std::atomic<std::uint64_t> bestStep{ExitEvent::NO_STEP}; // Earliest arrival step found so far
+    std::vector<ExitEvent> blockEvents(blocks);
+    swarm.setVisitShards(threads);
+
+#pragma omp parallel num_threads(threads)
+    {
+        // Each thread counts visits into its own shard
+        int shard = 0;
+#ifdef _OPENMP
+        shard = omp_get_thread_num();
+#endif
+        for (std::uint64_t epochStart = 0; ; epochStart += quantum) {
+#pragma omp for schedule(static)
+            for (int b = 0; b < blocks; ++b) {
+                // Steps past the best arrival so far cannot produce the winner
+                std::uint64_t best = bestStep.load(std::memory_order_relaxed);
+                int steps = quantum;
+                if (best != ExitEvent::NO_STEP) {
+                    steps = static_cast<int>(std::min<std::uint64_t>(quantum, best - epochStart + 1));
+                }
+
+                ExitEvent event = swarm.advance(b * block, std::min(count, (b + 1) * block), epochStart, steps, shard);
+                if (event.found()) {
+                    blockEvents[b] = event;
+                    while (event.step < best &&
+                           !bestStep.compare_exchange_weak(best, event.step, std::memory_order_relaxed)) { }
+                    token.cancel();
+                }
+            }
+
+            // Arrivals from a later epoch cannot be seen here, so every thread takes the same branch
+            if (bestStep.load(std::memory_order_relaxed) < epochStart + quantum) {
+                break;
+            }
+        }
+    }
+
+    stopLatency = std::chrono::duration<double>(CancellationToken::Clock::now() - token.getCancelTime()).count();
+    ExitEvent winner = *std::min_element(blockEvents.begin(), blockEvents.end());
+
+    // Blocks that finished the last epoch before the winner was known walked past it; trim
+    // the recorded walks back to where a sequential simulation stops
+    const std::uint64_t lastEpoch = winner.step / quantum * quantum;
+#pragma omp parallel for num_threads(threads) schedule(static)
+    for (int b = 0; b < blocks; ++b) {
+        int shard = 0;
+#ifdef _OPENMP
+        shard = omp_get_thread_num();
+#endif
+        swarm.rewind(b * block, std::min(count, (b + 1) * block), winner, lastEpoch, shard);
+    }
+    return winner;
+}
+
+double LockstepScheduler::getStopLatency() const {
+    return stopLatency;
+}
@@ -0,0 +1,27 @@
+#ifndef LOCKSTEP_SCHEDULER_H
+#define LOCKSTEP_SCHEDULER_H
+
+#include "particle_swarm.h"
+
+// Runs a swarm in epochs until a particle reaches the exit. Every epoch advances every
+// particle by a fixed quantum of steps, with the particles split into contiguous blocks
+// across threads. The exit event reported is the one a sequential simulation moving each
+// particle once per round would find, whatever the number of threads or the quantum.
+class LockstepScheduler {
+public:
+    LockstepScheduler(int quantum, int threads);
+
+    ExitEvent run(ParticleSwarm& swarm);
+
+    // Seconds from the first exit being found to every thread having stopped, for the last run
+    double getStopLatency() const;
+
+private:
+    static constexpr int MAX_BLOCK = 1024;  // Particles per work item
+
+    int quantum;
+    int threads;
+    double stopLatency;
+};
+
+#endif // LOCKSTEP_SCHEDULER_H
@@ -0,0 +1,58 @@
+#include "mapped_file.h"
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile() : base(nullptr), length(0) { }
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path, Access access) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Unable to open file for reading: " << path << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        std::cerr << "Unable to open file for reading: " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+    if (info.st_size == 0) {
+        ::close(fd);
+        return true;
+    }
+
+    void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping stays valid without the descriptor
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Unable to map file: " << path << std::endl;
+        return false;
+    }
+    base = mapping;
+    length = static_cast<size_t>(info.st_size);
+    madvise(base, length, access == RANDOM ? MADV_RANDOM : MADV_SEQUENTIAL);
+    return true;
+}
+
+void MappedFile::close() {
+    if (base) {
+        munmap(base, length);
+        base = nullptr;
+        length = 0;
+    }
+}
+
+const char* MappedFile::data() const {
+    return static_cast<const char*>(base);
+}
+
+size_t MappedFile::size() const {
+    return length;
+}
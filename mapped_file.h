@@ -0,0 +1,30 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// Whole file mapped read-only into memory
+class MappedFile {
+public:
+    // Expected access pattern, passed on to the kernel's read-ahead
+    enum Access { SEQUENTIAL, RANDOM };
+
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map the file; reports problems on std::cerr. Empty files map to no data.
+    bool open(const std::string& path, Access access = SEQUENTIAL);
+    void close();
+
+    const char* data() const;
+    size_t size() const;
+
+private:
+    void* base;
+    size_t length;
+};
+
+#endif // MAPPED_FILE_H
@@ -1,12 +1,16 @@
 #include "maze.h"
+#include "maze_stream.h"
+#include "packed_maze.h"
+#include "tiled_maze.h"
+#include "mapped_file.h"
+#include "maze_text.h"
+#include "maze_image.h"
+#include "maze_pyramid.h"
 #include <iostream>
-#include <fstream>
-#include <SFML/Graphics.hpp>
+#include <cstdio>
 #include <stack>
+#include <algorithm>
 #include <vector>
-#include <cstdlib>
-#include <ctime>
-#include <random>
 
 #define DEBUG_MODE
 
@@ -16,65 +20,89 @@
 #define DEBUG_MSG(msg)
 #endif
 
-Maze::Maze() : width(0), height(0), startX(0), startY(0), exitX(0), exitY(0) { }
+Maze::Maze() : width(0), height(0), startX(0), startY(0), exitX(0), exitY(0), seed(0), stride(2) { }
+
+// Allocate the padded grid; the border row/column on every side stays a wall
+void Maze::resize(int width, int height) {
+    this->width = width;
+    this->height = height;
+    stride = width + 2;
+    data.assign(static_cast<size_t>(height + 2) * stride + MazeView::GATHER_PADDING, WALL);
+}
 
 // Helper function to check if a cell is within bounds and is a wall
 bool Maze::isValid(int x, int y) const {
-    return x >= 0 && x < width && y >= 0 && y < height && data[y][x] == WALL;
+    return x >= 0 && x < width && y >= 0 && y < height && at(x, y) == WALL;
+}
+
+// Precompute the open-neighbour mask of every cell so walkers never have to probe walls
+void Maze::buildOpenMasks() {
+    const int offsets[4] = { stride, -stride, 1, -1 };  // Same order as DIRECTION_DX/DY
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            size_t index = static_cast<size_t>(y + 1) * stride + (x + 1);
+            int mask = 0;
+            for (int dir = 0; dir < 4; ++dir) {
+                if ((data[index + offsets[dir]] & MazeView::TYPE_BITS) != WALL) {
+                    mask |= 1 << dir;
+                }
+            }
+            data[index] = static_cast<std::uint8_t>((data[index] & MazeView::TYPE_BITS) | (mask << MazeView::OPEN_SHIFT));
+        }
+    }
 }
 
 // Generate the maze using Depth-First Search (DFS)
-void Maze::generateMaze(int startX, int startY) {
+void Maze::generateMaze(int startX, int startY, RandomStream& rng) {
     const int directions[4][2] = { {0, 2}, {0, -2}, {2, 0}, {-2, 0} };
 
     std::stack<std::pair<int, int>> stack;
     stack.push({startX, startY});
-    data[startY][startX] = PATH;
-
-    std::mt19937 rng(12345); // Fixed seed for reproducibility
+    at(startX, startY) = PATH;
 
     while (!stack.empty()) {
         auto [x, y] = stack.top();
         stack.pop();
 
-        std::vector<std::pair<int, int>> neighbors;
+        int neighbors[4][2];
+        int count = 0;
         for (const auto& dir : directions) {
             int nx = x + dir[0];
             int ny = y + dir[1];
             if (isValid(nx, ny)) {
                 int wx = x + dir[0] / 2;
                 int wy = y + dir[1] / 2;
-                if (data[wy][wx] == WALL) {
-                    neighbors.push_back({nx, ny});
+                if (at(wx, wy) == WALL) {
+                    neighbors[count][0] = nx;
+                    neighbors[count][1] = ny;
+                    ++count;
                 }
             }
         }
 
-        if (!neighbors.empty()) {
+        if (count > 0) {
             stack.push({x, y});
-            std::shuffle(neighbors.begin(), neighbors.end(), std::mt19937{std::random_device{}()}); // Shuffle to add randomness
-            auto [nx, ny] = neighbors.front();
+            const int* next = neighbors[uniformBelow(rng, count)]; // Pick a random unvisited neighbour
+            int nx = next[0], ny = next[1];
             int wx = x + (nx - x) / 2;
             int wy = y + (ny - y) / 2;
-            data[ny][nx] = PATH;
-            data[wy][wx] = PATH;
+            at(nx, ny) = PATH;
+            at(wx, wy) = PATH;
             stack.push({nx, ny});
         }
     }
 
     // Ensure a direct path from start to exit
     if (startX != exitX || startY != exitY) {
-        std::vector<std::pair<int, int>> path;
         int x = startX, y = startY;
         while (x != exitX || y != exitY) {
-            path.push_back({x, y});
             if (x < exitX) x++;
             else if (x > exitX) x--;
             if (y < exitY) y++;
             else if (y > exitY) y--;
-            if (data[y][x] != PATH) data[y][x] = PATH;
+            if (at(x, y) != PATH) at(x, y) = PATH;
         }
-        path.push_back({x, y});
     }
 
     DEBUG_MSG("Maze generation completed");
@@ -83,180 +111,219 @@ void Maze::generateMaze(int startX, int startY) {
 // Load the maze from a file
 bool Maze::loadFromFile(const std::string& filename) {
     std::string fullPath = "../input/" + filename;
-    std::ifstream file(fullPath);
-    if (!file) {
-        std::cerr << "Unable to open file for reading: " << fullPath << std::endl;
+    MappedFile file;
+    if (!file.open(fullPath)) {
         return false;
     }
+    const char* end = file.data() + file.size();
 
-    file >> height >> width;
-    if (height <= 0 || width <= 0) {
+    int fileHeight = 0, fileWidth = 0;
+    const char* cells = parseTextHeader(file.data(), end, fileHeight, fileWidth);
+    if (!cells) {
         std::cerr << "Invalid dimensions in maze file." << std::endl;
         return false;
     }
 
-    data.resize(height, std::vector<int>(width));
+    resize(fileWidth, fileHeight);
+    seed = 0;
+    long long startCell, exitCell;
+    switch (parseTextCells(cells, end, width, height, &at(0, 0), stride, startCell, exitCell)) {
+        case TextParseError::READ:
+            std::cerr << "Error reading maze data from file." << std::endl;
+            return false;
+        case TextParseError::VALUE:
+            std::cerr << "Invalid cell value in maze file." << std::endl;
+            return false;
+        default:
+            break;
+    }
+    startX = startCell < 0 ? -1 : static_cast<int>(startCell % width);
+    startY = startCell < 0 ? -1 : static_cast<int>(startCell / width);
+    exitX = exitCell < 0 ? -1 : static_cast<int>(exitCell % width);
+    exitY = exitCell < 0 ? -1 : static_cast<int>(exitCell / width);
+
+    buildOpenMasks();
+
+    DEBUG_MSG("Maze loaded successfully from file: " << fullPath);
+    return true;
+}
+
+// Load the maze from a packed binary file
+bool Maze::loadFromBinaryFile(const std::string& filename) {
+    std::string fullPath = "../input/" + filename;
+    MappedMaze mapped;
+    if (!mapped.open(fullPath)) {
+        return false;
+    }
+
+    const PackedMazeHeader& header = mapped.getHeader();
+    PackedMazeView cells = mapped.getData();
+    resize(cells.getWidth(), cells.getHeight());
     for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            if (!(file >> data[y][x])) {
-                std::cerr << "Error reading maze data from file." << std::endl;
-                return false;
-            }
-        }
+        cells.unpackRow(y, &at(0, y));
+    }
+    if (contentHash() != header.checksum) {
+        std::cerr << "Checksum mismatch in maze file: " << fullPath << std::endl;
+        return false;
     }
 
+    startX = header.startX;
+    startY = header.startY;
+    exitX = header.exitX;
+    exitY = header.exitY;
+    seed = header.seed;
+    buildOpenMasks();
+
     DEBUG_MSG("Maze loaded successfully from file: " << fullPath);
     return true;
 }
 
 // Initialize the maze with walls and set start and exit positions
-void Maze::initialize(int width, int height, int startX, int startY, int exitX, int exitY) {
+void Maze::initialize(int width, int height, int startX, int startY, int exitX, int exitY,
+                      std::uint64_t seed, Algorithm algorithm) {
     if (width < 3 || height < 3) {
         std::cerr << "Width and height must be at least 3." << std::endl;
         return;
     }
 
-    this->width = width;
-    this->height = height;
     this->startX = startX;
     this->startY = startY;
     this->exitX = exitX;
     this->exitY = exitY;
+    this->seed = seed;
 
-    data = std::vector<std::vector<int>>(height, std::vector<int>(width, WALL));
+    resize(width, height);
 
-    std::srand(static_cast<unsigned>(std::time(0))); // Seed for random number generation
-    generateMaze(startX, startY);
+    if (algorithm == BACKTRACKER) {
+        RandomStream rng(RandomStream::XOSHIRO, seed); // One engine for the whole maze
+        generateMaze(startX, startY, rng);
+    } else {
+        generateLattice(algorithm, seed);
+        connectEndpoints();
+    }
 
-    data[startY][startX] = START;
-    data[exitY][exitX] = EXIT;
+    at(startX, startY) = START;
+    at(exitX, exitY) = EXIT;
+    buildOpenMasks();
 
-    DEBUG_MSG("Maze initialized. Start: (" << startX << ", " << startY << "), Exit: (" << exitX << ", " << exitY << ")");
+    DEBUG_MSG("Maze initialized with seed " << seed << ". Start: (" << startX << ", " << startY << "), Exit: (" << exitX << ", " << exitY << ")");
 }
 
 // Save the maze to a file
-void Maze::saveToFile(const std::string& filename) const {
+bool Maze::saveToFile(const std::string& filename) const {
     std::string fullPath = "../input/" + filename;
-    std::ofstream file(fullPath);
+    std::FILE* file = std::fopen(fullPath.c_str(), "wb");
     if (!file) {
         std::cerr << "Unable to open file for writing: " << filename << std::endl;
-        return;
+        return false;
     }
 
-    file << height << " " << width << "\n";
-    for (const auto& row : data) {
-        for (size_t col = 0; col < row.size(); ++col) {
-            file << row[col];
-            if (col < row.size() - 1) {
-                file << ' ';
-            }
-        }
-        file << "\n";
+    bool ok = std::fprintf(file, "%d %d\n", height, width) > 0 &&
+              writeTextCells(file, data.data() + stride + 1, width, height, stride);  // From cell (0, 0)
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Error writing maze file: " << filename << std::endl;
+        return false;
     }
 
     DEBUG_MSG("Maze saved to file: " << filename);
+    return true;
+}
+
+bool Maze::writeRows(MazeRowSink& sink) const {
+    if (!sink.begin(width, height)) {
+        return false;
+    }
+    std::vector<std::uint8_t> row(width);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            row[x] = type(x, y);
+        }
+        if (!sink.writeRow(row.data())) {
+            return false;
+        }
+    }
+    return sink.end();
+}
+
+// Save the maze as a packed binary file
+bool Maze::saveToBinaryFile(const std::string& filename) const {
+    BinaryRowSink sink("../input/" + filename, startX, startY, exitX, exitY, seed);
+    if (!writeRows(sink)) {
+        std::cerr << "Error writing maze file: " << filename << std::endl;
+        return false;
+    }
+
+    DEBUG_MSG("Maze saved to binary file: " << filename);
+    return true;
+}
+
+// Save the maze as a tiled file
+bool Maze::saveToTiledFile(const std::string& filename) const {
+    TiledMazeWriter sink("../input/" + filename, startX, startY, exitX, exitY, seed);
+    if (!writeRows(sink)) {
+        std::cerr << "Error writing maze file: " << filename << std::endl;
+        return false;
+    }
+
+    DEBUG_MSG("Maze saved to tiled file: " << filename);
+    return true;
 }
 
 // Save the maze as an image
 void Maze::saveAsImage(const std::string& filename,
-                       const std::vector<std::vector<std::pair<int, int>>>& particlePaths,
-                       const std::vector<std::pair<int, int>>& exitPath,
+                       const std::vector<Trajectory>& particlePaths,
+                       const Trajectory& exitPath,
                        bool drawAdditionalElements) const {
     const int cellSize = 20;
     const int dotRadius = 2; // Radius of the dots
 
-    // Create an image with the size of the maze
-    sf::Image mazeImage;
-    mazeImage.create(width * cellSize, height * cellSize, sf::Color::White);
-
-    // Draw the maze
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            sf::Color color;
-            switch (data[y][x]) {
-                case WALL: color = sf::Color::Black; break;
-                case PATH: color = sf::Color::White; break;
-                case START: color = sf::Color::Green; break;
-                case EXIT: color = sf::Color::Red; break;
-                default: color = sf::Color::White; break;
-            }
-            for (int dy = 0; dy < cellSize; ++dy) {
-                for (int dx = 0; dx < cellSize; ++dx) {
-                    mazeImage.setPixel(x * cellSize + dx, y * cellSize + dy, color);
-                }
-            }
-        }
-    }
+    // Render into a raw RGBA buffer with the size of the maze
+    Framebuffer frame(width * cellSize, height * cellSize);
+    renderCells(getData(), cellSize, frame);
 
     // Draw additional elements if the flag is set to true
     if (drawAdditionalElements) {
         // Draw all paths with dots if paths exist
         if (!particlePaths.empty()) {
-            sf::Color dotColor = sf::Color::Blue;
-
-            for (const auto& path : particlePaths) {
-                for (const auto& point : path) {
-                    int px = point.first * cellSize + cellSize / 2;
-                    int py = point.second * cellSize + cellSize / 2;
-
-                    // Draw dot
-                    for (int dy = -dotRadius; dy <= dotRadius; ++dy) {
-                        for (int dx = -dotRadius; dx <= dotRadius; ++dx) {
-                            if (dx * dx + dy * dy <= dotRadius * dotRadius) {
-                                int x = px + dx;
-                                int y = py + dy;
-                                if (x >= 0 && x < width * cellSize && y >= 0 && y < height * cellSize) {
-                                    mazeImage.setPixel(x, y, dotColor);
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-
+            drawDots(particlePaths, cellSize, dotRadius, BLUE, frame);
             DEBUG_MSG("Particle paths drawn on maze image.");
         }
 
         // Draw the exit path with a line if it exists
         if (!exitPath.empty()) {
-            sf::Color lineColor = sf::Color::Red;
-
-            for (size_t i = 1; i < exitPath.size(); ++i) {
-                int x1 = exitPath[i - 1].first * cellSize + cellSize / 2;
-                int y1 = exitPath[i - 1].second * cellSize + cellSize / 2;
-                int x2 = exitPath[i].first * cellSize + cellSize / 2;
-                int y2 = exitPath[i].second * cellSize + cellSize / 2;
-
-                // Draw line between two points
-                int dx = std::abs(x2 - x1);
-                int dy = std::abs(y2 - y1);
-                int sx = (x1 < x2) ? 1 : -1;
-                int sy = (y1 < y2) ? 1 : -1;
-                int err = dx - dy;
-
-                while (true) {
-                    if (x1 >= 0 && x1 < width * cellSize && y1 >= 0 && y1 < height * cellSize) {
-                        mazeImage.setPixel(x1, y1, lineColor);
-                    }
-                    if (x1 == x2 && y1 == y2) break;
-                    int e2 = 2 * err;
-                    if (e2 > -dy) { err -= dy; x1 += sx; }
-                    if (e2 < dx) { err += dx; y1 += sy; }
-                }
-            }
-
+            drawPath(exitPath, cellSize, RED, frame);
             DEBUG_MSG("Exit path drawn on maze image.");
         }
     }
 
-    // Save the image to file
-    if (mazeImage.saveToFile(filename)) {
+    if (saveFramebuffer(frame, filename)) {
         DEBUG_MSG("Maze image saved to: " << filename);
-    } else {
-        std::cerr << "Failed to save maze image to: " << filename << std::endl;
     }
 }
 
+// Save the maze as a visit count heatmap
+void Maze::saveAsHeatmap(const std::string& filename, const VisitCounts& visits, const Trajectory& exitPath) const {
+    const int cellSize = 20;
+
+    Framebuffer frame(width * cellSize, height * cellSize);
+    renderHeatmap(getData(), visits, cellSize, frame);
+    drawPath(exitPath, cellSize, RED, frame);
+    if (saveFramebuffer(frame, filename)) {
+        DEBUG_MSG("Maze image saved to: " << filename);
+    }
+}
+
+// Save the maze as a tiled image pyramid
+bool Maze::saveAsImagePyramid(const std::string& directory) const {
+    if (!writeImagePyramid(getData(), startX, startY, exitX, exitY, directory)) {
+        std::cerr << "Failed to save image pyramid to: " << directory << std::endl;
+        return false;
+    }
+    DEBUG_MSG("Maze image pyramid saved to: " << directory);
+    return true;
+}
+
 // Getter for width
 int Maze::getWidth() const {
     return width;
@@ -268,10 +335,26 @@ int Maze::getHeight() const {
 }
 
 // Getter for maze data
-const std::vector<std::vector<int>>& Maze::getData() const {
-    return data;
+MazeView Maze::getData() const {
+    return MazeView(data.data(), width, height, stride);
+}
+
+std::uint64_t Maze::getSeed() const {
+    return seed;
 }
 
 int Maze::getSize() const {
     return width * height;
 }
+
+std::uint64_t Maze::contentHash() const {
+    std::uint64_t hash = hashDimensions(width, height);
+    std::vector<std::uint8_t> row(width);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            row[x] = type(x, y);
+        }
+        hash = fnv1a(hash, row.data(), row.size());
+    }
+    return hash;
+}
@@ -1,40 +1,146 @@
 #ifndef MAZE_H
 #define MAZE_H
 
+#include <cstdint>
 #include <vector>
 #include <string>
+#include "trajectory.h"
+#include "rng.h"
+#include "maze_stream.h"
+
+class VisitCounts;
+
+// Lightweight read-only view over the maze cell grid.
+// Cells are stored row-major in one contiguous block surrounded by a one-cell wall border,
+// so the neighbours of any interior cell can be read without bounds checks.
+class MazeView {
+public:
+    // Each cell byte holds the cell type in its low bits and the open-neighbour mask above it
+    static constexpr std::uint8_t TYPE_BITS = 0x03;
+    static constexpr int OPEN_SHIFT = 2;
+
+    // Bytes allocated past the last cell so vector kernels can gather 4-byte words at any cell
+    static constexpr int GATHER_PADDING = 3;
+
+    MazeView(const std::uint8_t* cells, int width, int height, int stride)
+        : cells(cells), width(width), height(height), stride(stride) { }
+
+    // Cell type at interior coordinates; x == -1, x == width, y == -1 and y == height hit the border
+    std::uint8_t operator()(int x, int y) const { return cells[index(x, y)] & TYPE_BITS; }
+
+    // Cell type at a linear index into the padded grid
+    std::uint8_t operator[](int index) const { return cells[index] & TYPE_BITS; }
+
+    // Open-neighbour mask at a linear index (see walk.h for the direction order)
+    std::uint8_t openMask(int index) const { return cells[index] >> OPEN_SHIFT; }
+    std::uint8_t openMask(int x, int y) const { return openMask(index(x, y)); }
+
+    // Conversions between interior coordinates and linear indices
+    int index(int x, int y) const { return (y + 1) * stride + (x + 1); }
+    int xOf(int index) const { return index % stride - 1; }
+    int yOf(int index) const { return index / stride - 1; }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getStride() const { return stride; }
+    const std::uint8_t* getCells() const { return cells; }
+
+private:
+    const std::uint8_t* cells;
+    int width;
+    int height;
+    int stride;
+};
 
 class Maze {
 public:
     Maze();
 
+    // Maze generation algorithms
+    enum Algorithm {
+        BACKTRACKER,           // Depth-first search over the whole grid
+        TILED_BACKTRACKER,     // Depth-first search per tile in parallel, tiles joined by a spanning tree of doors
+        IN_PLACE_BACKTRACKER,  // Depth-first search that backtracks through parent directions kept in the grid
+        KRUSKAL,               // Random spanning tree from shuffled walls and union-find
+        PRIM,                  // Grows one tree from a random frontier cell
+        WILSON,                // Uniform spanning tree from loop-erased random walks
+        SIDEWINDER,            // Row by row runs, each opened upwards once
+        RECURSIVE_DIVISION     // Splits open chambers with walls that keep one passage
+    };
+
     // Methods to initialize, load, and save the maze
-    void initialize(int width, int height, int startX, int startY, int exitX, int exitY);
+    // The same seed always generates the same maze, whatever the number of threads
+    void initialize(int width, int height, int startX, int startY, int exitX, int exitY,
+                    std::uint64_t seed = 12345, Algorithm algorithm = BACKTRACKER);
     bool loadFromFile(const std::string& filename);
-    void saveToFile(const std::string& filename) const;
+    bool saveToFile(const std::string& filename) const;
+
+    // Packed binary format (packed_maze.h); loading checks the stored checksum
+    bool loadFromBinaryFile(const std::string& filename);
+    bool saveToBinaryFile(const std::string& filename) const;
+
+    // Tiled format for out-of-core walks (tiled_maze.h)
+    bool saveToTiledFile(const std::string& filename) const;
+
+    // Hand the cell types to a sink row by row
+    bool writeRows(MazeRowSink& sink) const;
     void saveAsImage(const std::string& filename,
-                     const std::vector<std::vector<std::pair<int, int>>>& particlePaths,
-                     const std::vector<std::pair<int, int>>& exitPath,
+                     const std::vector<Trajectory>& particlePaths,
+                     const Trajectory& exitPath,
                      bool drawAdditionalElements) const;
 
+    // Save the maze as a tiled image pyramid under the given directory (maze_pyramid.h)
+    bool saveAsImagePyramid(const std::string& directory) const;
+
+    // Save the maze as an image with visited cells shaded by visit count and the exit path on top
+    void saveAsHeatmap(const std::string& filename, const VisitCounts& visits, const Trajectory& exitPath) const;
+
     // Getters for maze dimensions and size
     int getWidth() const;
     int getHeight() const;
     int getSize() const;  // New method to get the size of the maze
+    std::uint64_t getSeed() const;
+
+    // FNV-1a hash of the dimensions and cell types (see maze_stream.h)
+    std::uint64_t contentHash() const;
 
     // Getter for the maze data
-    const std::vector<std::vector<int>>& getData() const;
+    MazeView getData() const;
 
     // Enum for cell types, made public for access in other classes
     enum CellType { WALL = 0, PATH = 1, START = 2, EXIT = 3 };
 
 private:
     // Method to generate the maze using DFS
-    void generateMaze(int startX, int startY);
+    void generateMaze(int startX, int startY, RandomStream& rng);
+
+    // Perfect-maze generators over the cell lattice (maze_generators.cpp)
+    void generateLattice(Algorithm algorithm, std::uint64_t seed);
+    void generateTiled(std::uint64_t seed);
+    void carveTile(int firstColumn, int firstRow, int lastColumn, int lastRow, std::uint64_t tileSeed);
+    void generateKruskal(RandomStream& rng);
+    void generatePrim(RandomStream& rng);
+    void generateWilson(RandomStream& rng);
+    void generateSidewinder(RandomStream& rng);
+    void generateRecursiveDivision(RandomStream& rng);
+
+    // Open the corridors joining off-lattice start and exit positions to the lattice
+    void connectEndpoints();
 
     // Helper method to validate cell coordinates
     bool isValid(int x, int y) const;
 
+    // Helpers to access a cell by interior coordinates
+    std::uint8_t& at(int x, int y) { return data[(y + 1) * stride + (x + 1)]; }
+    std::uint8_t at(int x, int y) const { return data[(y + 1) * stride + (x + 1)]; }
+    std::uint8_t type(int x, int y) const { return at(x, y) & MazeView::TYPE_BITS; }
+
+    // Store the open-neighbour mask of every cell next to its type
+    void buildOpenMasks();
+
+    // Allocate a grid of the given size filled with walls
+    void resize(int width, int height);
+
     // Maze attributes
     int width;
     int height;
@@ -42,7 +148,15 @@ private:
     int startY;
     int exitX;
     int exitY;
-    std::vector<std::vector<int>> data;  // 2D grid representing the maze
+    std::uint64_t seed;               // Seed the maze was generated from (0 when loaded)
+    int stride;                       // Row stride of the padded grid (width + 2)
+    std::vector<std::uint8_t> data;   // Padded row-major grid representing the maze
 };
 
+// Name of a generation algorithm, e.g. for benchmark reports
+const char* algorithmName(Maze::Algorithm algorithm);
+
+// Algorithm with the given name; returns false if there is none
+bool parseAlgorithm(const std::string& name, Maze::Algorithm& algorithm);
+
 #endif // MAZE_H
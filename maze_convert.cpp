@@ -0,0 +1,39 @@
+#include "maze.h"
+#include <iostream>
+#include <string>
+
+// True if the file name ends with the given extension
+bool hasExtension(const std::string& filename, const std::string& extension) {
+    return filename.size() >= extension.size() &&
+           filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+// Convert mazes between the text format, the packed binary format (.bin) and, as output
+// only, the tiled format (.tiles). All files are looked up in ../input/ like every other
+// maze file.
+int main(int argc, char* argv[]) {
+    if (argc != 3 || hasExtension(argv[1], ".tiles") ||
+        (hasExtension(argv[1], ".bin") && hasExtension(argv[2], ".bin")) ||
+        (!hasExtension(argv[1], ".bin") && !hasExtension(argv[2], ".bin") && !hasExtension(argv[2], ".tiles"))) {
+        std::cerr << "Usage: " << argv[0] << " <maze.txt> <maze.bin|maze.tiles>" << std::endl;
+        std::cerr << "       " << argv[0] << " <maze.bin> <maze.txt|maze.tiles>" << std::endl;
+        return 1;
+    }
+
+    Maze maze;
+    std::string input = argv[1];
+    std::string output = argv[2];
+    bool loaded = hasExtension(input, ".bin") ? maze.loadFromBinaryFile(input) : maze.loadFromFile(input);
+    if (!loaded) {
+        std::cerr << "Failed to load maze from file: " << input << std::endl;
+        return 1;
+    }
+
+    if (hasExtension(output, ".tiles")) {
+        return maze.saveToTiledFile(output) ? 0 : 1;
+    }
+    if (hasExtension(output, ".bin")) {
+        return maze.saveToBinaryFile(output) ? 0 : 1;
+    }
+    return maze.saveToFile(output) ? 0 : 1;
+}
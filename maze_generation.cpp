@@ -1,8 +1,15 @@
 #include "maze.h"
+#include "eller_generator.h"
+#include "maze_stream.h"
 #include <iostream>
+#include <fstream>
 #include <filesystem>
+#include <sstream>
 #include <string>
 #include <vector>
+#include <set>
+#include <cstdlib>
+#include <iomanip>
 
 namespace fs = std::filesystem;
 
@@ -14,28 +21,187 @@ namespace fs = std::filesystem;
 #define DEBUG_MSG(msg)
 #endif
 
-void generateMaze(const std::string& filename, int size) {
+// `count` mazes of one size and algorithm, seeded seed, seed + 1, ...
+struct GenerationJob {
+    int size;
+    Maze::Algorithm algorithm;
+    std::uint64_t seed;
+    int count;
+};
+
+// One generated maze as recorded in the manifest
+struct ManifestEntry {
+    std::string filename;  // Without directory or extension
+    int size;
+    Maze::Algorithm algorithm;
+    std::uint64_t seed;
+    bool streamed;         // Too large for memory; generated with Eller's algorithm
+    std::uint64_t hash;
+    bool generated;
+};
+
+// Parse a non-negative decimal number that fills the whole field
+bool parseNumber(const std::string& field, unsigned long long& value) {
+    if (field.empty() || field[0] == '-') {
+        return false;
+    }
+    char* end = nullptr;
+    value = std::strtoull(field.c_str(), &end, 10);
+    return *end == '\0';
+}
+
+// Parse a job written as size,algorithm,seed,count
+bool parseJob(const std::string& text, GenerationJob& job) {
+    std::vector<std::string> fields;
+    std::istringstream stream(text);
+    std::string field;
+    while (std::getline(stream, field, ',')) {
+        fields.push_back(field);
+    }
+
+    unsigned long long size, seed, count;
+    if (fields.size() != 4 || !parseNumber(fields[0], size) || !parseNumber(fields[2], seed) ||
+        !parseNumber(fields[3], count) || !parseAlgorithm(fields[1], job.algorithm)) {
+        return false;
+    }
+    if (size < 3 || size > 1000000000 || count < 1 || count > 1000000000) {
+        return false;
+    }
+    job.size = static_cast<int>(size);
+    job.seed = seed;
+    job.count = static_cast<int>(count);
+    return true;
+}
+
+// Stream a maze too large to hold in memory straight to its text file, one row at a time
+bool generateStreamedMaze(const std::string& filename, int size, std::uint64_t seed, std::uint64_t& hash) {
+    const int startX = 1, startY = 1;
+    int exitX = size - 2, exitY = size - 2;
+
+    DEBUG_MSG("Streaming a new maze of size " << size << "x" << size << " with Eller's algorithm");
+    TextRowSink file(filename + ".txt");
+    HashingRowSink sink(file);
+    EllerGenerator generator(size, size, startX, startY, exitX, exitY, seed);
+    if (!generator.generate(sink)) {
+        std::cerr << "Failed to stream maze to file: " << filename << ".txt" << std::endl;
+        return false;
+    }
+    hash = sink.getHash();
+    DEBUG_MSG("Maze saved to file: " << filename + ".txt");
+    return true;
+}
+
+bool generateMaze(const std::string& filename, int size, std::uint64_t seed, Maze::Algorithm algorithm,
+                  std::uint64_t& hash) {
     Maze maze;
     const int startX = 1, startY = 1;
     int exitX = size - 2, exitY = size - 2;
     std::string extensions[2] = {".txt", ".png"};
 
     DEBUG_MSG("Initializing a new maze of size " << size << "x" << size);
-    maze.initialize(size, size, startX, startY, exitX, exitY);
-    maze.saveToFile(filename + extensions[0]);
+    maze.initialize(size, size, startX, startY, exitX, exitY, seed, algorithm);
+    if (!maze.saveToFile(filename + extensions[0])) {
+        return false;
+    }
     if (size < 100) {
         maze.saveAsImage(filename + ".png", {}, {}, false);
         DEBUG_MSG("Maze image saved as " << filename + extensions[1]);
+    } else {
+        // Large mazes get tiles at several resolutions instead of one huge bitmap
+        maze.saveAsImagePyramid(filename + "_pyramid");
+    }
+    hash = maze.contentHash();
+    return true;
+}
+
+// Generate one entry of the manifest, recording whether its text file was written
+void generateEntry(const std::string& directory, ManifestEntry& entry) {
+    std::string path = directory + entry.filename;
+    if (entry.streamed) {
+        entry.generated = generateStreamedMaze(path, entry.size, entry.seed, entry.hash);
+    } else {
+        entry.generated = generateMaze(path, entry.size, entry.seed, entry.algorithm, entry.hash);
     }
 }
 
-int main() {
-    // sizes
-    //    std::vector<int> sizes = {50, 100,1000};
-    std::vector<int> sizes = {50,100};
-    for (int size : sizes) {
-        std::string filename = "../input/maze_" + std::to_string(size);
-        generateMaze(filename, size);
+int main(int argc, char* argv[]) {
+    const int maxInMemorySize = 16384;  // Larger mazes are streamed row by row
+    const int maxParallelSize = 4096;   // Larger in-memory mazes are generated one at a time
+    const std::string directory = "../input/";
+
+    // Without arguments, regenerate the default corpus under its usual names
+    std::vector<GenerationJob> jobs;
+    bool defaultCorpus = argc < 2;
+    if (defaultCorpus) {
+        jobs = { {50, Maze::BACKTRACKER, 12345, 1}, {100, Maze::BACKTRACKER, 12345, 1} };
+    }
+    for (int i = 1; i < argc; ++i) {
+        GenerationJob job;
+        if (!parseJob(argv[i], job)) {
+            std::cerr << "Invalid job: " << argv[i] << std::endl;
+            std::cerr << "Usage: " << argv[0] << " [size,algorithm,seed,count ...]" << std::endl;
+            std::cerr << "Algorithms:";
+            for (int a = Maze::BACKTRACKER; a <= Maze::RECURSIVE_DIVISION; ++a) {
+                std::cerr << " " << algorithmName(static_cast<Maze::Algorithm>(a));
+            }
+            std::cerr << std::endl;
+            return 1;
+        }
+        jobs.push_back(job);
+    }
+
+    // One entry per maze; repeated jobs would only rewrite the same file
+    std::vector<ManifestEntry> entries;
+    std::set<std::string> filenames;
+    for (const auto& job : jobs) {
+        for (int i = 0; i < job.count; ++i) {
+            ManifestEntry entry = {};
+            entry.size = job.size;
+            entry.algorithm = job.algorithm;
+            entry.seed = job.seed + static_cast<std::uint64_t>(i);
+            entry.streamed = job.size > maxInMemorySize;
+            entry.filename = "maze_" + std::to_string(job.size);
+            if (!defaultCorpus) {
+                entry.filename += std::string("_") + (entry.streamed ? "eller" : algorithmName(job.algorithm)) +
+                                  "_" + std::to_string(entry.seed);
+            }
+            if (filenames.insert(entry.filename).second) {
+                entries.push_back(entry);
+            }
+        }
+    }
+
+    // Streamed and small mazes are independent and take little memory, so they are spread over
+    // all cores; a large in-memory maze holds gigabytes, so those run one at a time
+    std::vector<size_t> parallel, serial;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        bool large = !entries[i].streamed && entries[i].size > maxParallelSize;
+        (large ? serial : parallel).push_back(i);
+    }
+#pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < parallel.size(); ++i) {
+        generateEntry(directory, entries[parallel[i]]);
+    }
+    for (size_t i : serial) {
+        generateEntry(directory, entries[i]);
+    }
+
+    std::ofstream manifest(directory + "manifest.csv");
+    if (!manifest) {
+        std::cerr << "Unable to open file for writing: " << directory << "manifest.csv" << std::endl;
+        return 1;
+    }
+    manifest << "File,Size,Algorithm,Seed,Content hash\n";
+    int failed = 0;
+    for (const auto& entry : entries) {
+        if (!entry.generated) {
+            ++failed;
+            continue;
+        }
+        manifest << entry.filename << ".txt," << entry.size << ","
+                 << (entry.streamed ? "eller" : algorithmName(entry.algorithm)) << "," << entry.seed << ","
+                 << std::hex << std::setw(16) << std::setfill('0') << entry.hash << std::dec << "\n";
     }
-    return 0;
+    DEBUG_MSG("Generated " << entries.size() - failed << " mazes; manifest saved to " << directory << "manifest.csv");
+    return failed == 0 ? 0 : 1;
 }
@@ -0,0 +1,46 @@
+#include "maze.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <iomanip>
+#include <fstream>
+
+int main() {
+    std::vector<int> sizes = {101, 1001, 4001};
+    std::vector<Maze::Algorithm> algorithms = {
+        Maze::BACKTRACKER, Maze::TILED_BACKTRACKER, Maze::IN_PLACE_BACKTRACKER, Maze::KRUSKAL, Maze::PRIM,
+        Maze::WILSON, Maze::SIDEWINDER, Maze::RECURSIVE_DIVISION
+    };
+    const std::uint64_t seed = 12345;  // Same seed, same mazes
+    const int repetitions = 3;         // Best of several runs
+
+    std::ofstream csvFile("../output/generation_times.csv");
+    csvFile << "Algorithm,Size,Time (seconds),Cells per second\n" << std::fixed;
+
+    for (Maze::Algorithm algorithm : algorithms) {
+        for (int size : sizes) {
+            double best = 0;
+            for (int run = 0; run < repetitions; ++run) {
+                Maze maze;
+                auto startTime = std::chrono::high_resolution_clock::now();
+                maze.initialize(size, size, 1, 1, size - 2, size - 2, seed, algorithm);
+                auto endTime = std::chrono::high_resolution_clock::now();
+                std::chrono::duration<double> elapsed = endTime - startTime;
+                if (run == 0 || elapsed.count() < best) {
+                    best = elapsed.count();
+                }
+            }
+
+            double cellsPerSecond = static_cast<double>(size) * size / best;
+            std::cout << algorithmName(algorithm) << " " << size << "x" << size << ": "
+                      << std::fixed << std::setprecision(4) << best << " seconds, "
+                      << std::setprecision(0) << cellsPerSecond << " cells/second" << std::endl;
+            csvFile << algorithmName(algorithm) << "," << size << "," << std::setprecision(6) << best << ","
+                    << std::setprecision(0) << cellsPerSecond << "\n";
+        }
+    }
+
+    csvFile.close();
+    return 0;
+}
@@ -0,0 +1,424 @@
+#include "maze.h"
+#include "maze_lattice.h"
+#include <algorithm>
+#include <numeric>
+#include <stack>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Lattice cells along each side of a tile
+const int TILE_CELLS = 64;
+
+// Lattice steps down, up, right and left, in the order of DIRECTION_DX/DY
+const int LATTICE_DX[4] = { 0, 0, 1, -1 };
+const int LATTICE_DY[4] = { 1, -1, 0, 0 };
+
+// Union-find over a fixed number of elements
+struct DisjointSets {
+    std::vector<int> parent;
+
+    explicit DisjointSets(int count) : parent(count) {
+        std::iota(parent.begin(), parent.end(), 0);
+    }
+
+    int find(int x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    // Join the sets of a and b; returns false if they were already joined
+    bool unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) {
+            return false;
+        }
+        parent[b] = a;
+        return true;
+    }
+};
+
+// Seeded Fisher-Yates shuffle
+void shuffle(std::vector<int>& values, RandomStream& rng) {
+    for (size_t i = values.size(); i > 1; --i) {
+        std::swap(values[i - 1], values[uniformBelow(rng, static_cast<std::uint32_t>(i))]);
+    }
+}
+
+} // namespace
+
+const char* algorithmName(Maze::Algorithm algorithm) {
+    switch (algorithm) {
+        case Maze::BACKTRACKER: return "backtracker";
+        case Maze::TILED_BACKTRACKER: return "tiled-backtracker";
+        case Maze::IN_PLACE_BACKTRACKER: return "in-place-backtracker";
+        case Maze::KRUSKAL: return "kruskal";
+        case Maze::PRIM: return "prim";
+        case Maze::WILSON: return "wilson";
+        case Maze::SIDEWINDER: return "sidewinder";
+        case Maze::RECURSIVE_DIVISION: return "recursive-division";
+        default: return "unknown";
+    }
+}
+
+bool parseAlgorithm(const std::string& name, Maze::Algorithm& algorithm) {
+    for (int i = Maze::BACKTRACKER; i <= Maze::RECURSIVE_DIVISION; ++i) {
+        if (name == algorithmName(static_cast<Maze::Algorithm>(i))) {
+            algorithm = static_cast<Maze::Algorithm>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void Maze::generateLattice(Algorithm algorithm, std::uint64_t seed) {
+    if (algorithm == TILED_BACKTRACKER) {
+        generateTiled(seed);
+        return;
+    }
+    if (algorithm == IN_PLACE_BACKTRACKER) {
+        carveTile(0, 0, latticeCells(width), latticeCells(height), seed);  // One tile covering the maze
+        return;
+    }
+
+    RandomStream rng(RandomStream::XOSHIRO, seed);
+    switch (algorithm) {
+        case KRUSKAL: generateKruskal(rng); break;
+        case PRIM: generatePrim(rng); break;
+        case WILSON: generateWilson(rng); break;
+        case SIDEWINDER: generateSidewinder(rng); break;
+        case RECURSIVE_DIVISION: generateRecursiveDivision(rng); break;
+        default: break;
+    }
+}
+
+void Maze::connectEndpoints() {
+    const int points[2][2] = { { startX, startY }, { exitX, exitY } };
+    for (const auto& point : points) {
+        int ox = nearestLatticeCoordinate(point[0], width);
+        int oy = nearestLatticeCoordinate(point[1], height);
+        for (int x = std::min(ox, point[0]); x <= std::max(ox, point[0]); ++x) {
+            at(x, point[1]) = PATH;
+        }
+        for (int y = std::min(oy, point[1]); y <= std::max(oy, point[1]); ++y) {
+            at(ox, y) = PATH;
+        }
+    }
+}
+
+// Carve a perfect maze over lattice cells [firstColumn, lastColumn) x [firstRow, lastRow)
+// with a depth-first search that never leaves the tile. There is no stack: every carved cell
+// keeps the direction back to its parent in the bits that later hold its open-neighbour mask,
+// so backtracking walks the grid itself and needs no memory beyond it.
+void Maze::carveTile(int firstColumn, int firstRow, int lastColumn, int lastRow, std::uint64_t tileSeed) {
+    RandomStream rng(RandomStream::XOSHIRO, tileSeed);
+    int cx = firstColumn;
+    int cy = firstRow;
+    at(2 * cx + 1, 2 * cy + 1) = PATH;
+
+    while (true) {
+        int neighbors[4];
+        int count = 0;
+        for (int dir = 0; dir < 4; ++dir) {
+            int nx = cx + LATTICE_DX[dir];
+            int ny = cy + LATTICE_DY[dir];
+            if (nx >= firstColumn && nx < lastColumn && ny >= firstRow && ny < lastRow &&
+                type(2 * nx + 1, 2 * ny + 1) == WALL) {
+                neighbors[count++] = dir;
+            }
+        }
+
+        if (count == 0) {
+            if (cx == firstColumn && cy == firstRow) {
+                break;
+            }
+            int back = at(2 * cx + 1, 2 * cy + 1) >> MazeView::OPEN_SHIFT;
+            cx += LATTICE_DX[back];
+            cy += LATTICE_DY[back];
+            continue;
+        }
+
+        int dir = neighbors[uniformBelow(rng, count)];
+        at(2 * cx + 1 + LATTICE_DX[dir], 2 * cy + 1 + LATTICE_DY[dir]) = PATH;
+        cx += LATTICE_DX[dir];
+        cy += LATTICE_DY[dir];
+        // Directions pair up as down/up and right/left, so dir ^ 1 points back
+        at(2 * cx + 1, 2 * cy + 1) = static_cast<std::uint8_t>(PATH | ((dir ^ 1) << MazeView::OPEN_SHIFT));
+    }
+}
+
+// Carve every tile independently in parallel, then open one door per edge of a random
+// spanning tree over the tiles so the whole maze stays a single perfect maze
+void Maze::generateTiled(std::uint64_t seed) {
+    const int columns = latticeCells(width);
+    const int rows = latticeCells(height);
+    const int tilesX = (columns + TILE_CELLS - 1) / TILE_CELLS;
+    const int tilesY = (rows + TILE_CELLS - 1) / TILE_CELLS;
+    const int tiles = tilesX * tilesY;
+
+    // Tile seeds depend only on the maze seed and the tile, never on the thread carving it
+#pragma omp parallel for schedule(dynamic)
+    for (int tile = 0; tile < tiles; ++tile) {
+        int tx = tile % tilesX;
+        int ty = tile / tilesX;
+        carveTile(tx * TILE_CELLS, ty * TILE_CELLS,
+                  std::min(columns, (tx + 1) * TILE_CELLS), std::min(rows, (ty + 1) * TILE_CELLS),
+                  splitMix64(seed ^ splitMix64(static_cast<std::uint64_t>(tile))));
+    }
+
+    // Candidate doors between horizontally (even index) and vertically (odd index) adjacent tiles
+    std::vector<int> edges;
+    for (int tile = 0; tile < tiles; ++tile) {
+        if (tile % tilesX + 1 < tilesX) {
+            edges.push_back(2 * tile);
+        }
+        if (tile / tilesX + 1 < tilesY) {
+            edges.push_back(2 * tile + 1);
+        }
+    }
+
+    // Kruskal over shuffled tile edges
+    RandomStream rng(RandomStream::XOSHIRO, seed);
+    shuffle(edges, rng);
+    DisjointSets tileSets(tiles);
+    for (int edge : edges) {
+        int tile = edge / 2;
+        bool horizontal = edge % 2 == 0;
+        if (!tileSets.unite(tile, horizontal ? tile + 1 : tile + tilesX)) {
+            continue;
+        }
+
+        // Open the wall between two lattice cells at a random point of the shared border
+        int tx = tile % tilesX;
+        int ty = tile / tilesX;
+        if (horizontal) {
+            int firstRow = ty * TILE_CELLS;
+            int span = std::min(rows, firstRow + TILE_CELLS) - firstRow;
+            int cy = firstRow + static_cast<int>(uniformBelow(rng, span));
+            at(2 * (tx + 1) * TILE_CELLS, 2 * cy + 1) = PATH;
+        } else {
+            int firstColumn = tx * TILE_CELLS;
+            int span = std::min(columns, firstColumn + TILE_CELLS) - firstColumn;
+            int cx = firstColumn + static_cast<int>(uniformBelow(rng, span));
+            at(2 * cx + 1, 2 * (ty + 1) * TILE_CELLS) = PATH;
+        }
+    }
+}
+
+// Open every lattice wall in random order unless it would join two already connected cells
+void Maze::generateKruskal(RandomStream& rng) {
+    const int columns = latticeCells(width);
+    const int rows = latticeCells(height);
+
+    // Wall to the right of a cell (even index) or below it (odd index)
+    std::vector<int> edges;
+    edges.reserve(2 * static_cast<size_t>(columns) * rows);
+    for (int cell = 0; cell < columns * rows; ++cell) {
+        at(2 * (cell % columns) + 1, 2 * (cell / columns) + 1) = PATH;
+        if (cell % columns + 1 < columns) {
+            edges.push_back(2 * cell);
+        }
+        if (cell / columns + 1 < rows) {
+            edges.push_back(2 * cell + 1);
+        }
+    }
+    shuffle(edges, rng);
+
+    DisjointSets sets(columns * rows);
+    for (int edge : edges) {
+        int cell = edge / 2;
+        bool horizontal = edge % 2 == 0;
+        if (sets.unite(cell, horizontal ? cell + 1 : cell + columns)) {
+            int cx = cell % columns;
+            int cy = cell / columns;
+            if (horizontal) {
+                at(2 * cx + 2, 2 * cy + 1) = PATH;
+            } else {
+                at(2 * cx + 1, 2 * cy + 2) = PATH;
+            }
+        }
+    }
+}
+
+// Grow the maze from a random cell, each time linking a random frontier cell to the maze
+void Maze::generatePrim(RandomStream& rng) {
+    enum State : std::uint8_t { OUTSIDE, FRONTIER, INSIDE };
+    const int columns = latticeCells(width);
+    const int rows = latticeCells(height);
+    std::vector<std::uint8_t> state(static_cast<size_t>(columns) * rows, OUTSIDE);
+    std::vector<int> frontier;
+
+    auto add = [&](int cx, int cy) {
+        at(2 * cx + 1, 2 * cy + 1) = PATH;
+        state[cy * columns + cx] = INSIDE;
+        for (int dir = 0; dir < 4; ++dir) {
+            int nx = cx + LATTICE_DX[dir];
+            int ny = cy + LATTICE_DY[dir];
+            if (nx >= 0 && nx < columns && ny >= 0 && ny < rows && state[ny * columns + nx] == OUTSIDE) {
+                state[ny * columns + nx] = FRONTIER;
+                frontier.push_back(ny * columns + nx);
+            }
+        }
+    };
+
+    int first = static_cast<int>(uniformBelow(rng, columns * rows));
+    add(first % columns, first / columns);
+
+    while (!frontier.empty()) {
+        size_t pick = uniformBelow(rng, static_cast<std::uint32_t>(frontier.size()));
+        int cell = frontier[pick];
+        frontier[pick] = frontier.back();
+        frontier.pop_back();
+
+        // Link it to a random neighbour already in the maze
+        int cx = cell % columns;
+        int cy = cell / columns;
+        int neighbors[4];
+        int count = 0;
+        for (int dir = 0; dir < 4; ++dir) {
+            int nx = cx + LATTICE_DX[dir];
+            int ny = cy + LATTICE_DY[dir];
+            if (nx >= 0 && nx < columns && ny >= 0 && ny < rows && state[ny * columns + nx] == INSIDE) {
+                neighbors[count++] = dir;
+            }
+        }
+        int dir = neighbors[uniformBelow(rng, count)];
+        at(2 * cx + 1 + LATTICE_DX[dir], 2 * cy + 1 + LATTICE_DY[dir]) = PATH;
+        add(cx, cy);
+    }
+}
+
+// Join every cell to the maze through a loop-erased random walk, giving a uniform spanning tree
+void Maze::generateWilson(RandomStream& rng) {
+    const int columns = latticeCells(width);
+    const int rows = latticeCells(height);
+    const int cells = columns * rows;
+    std::vector<std::uint8_t> inMaze(cells, 0);
+    std::vector<std::uint8_t> exitDir(cells, 0);  // Last direction the walk left each cell by
+
+    int first = static_cast<int>(uniformBelow(rng, cells));
+    inMaze[first] = 1;
+    at(2 * (first % columns) + 1, 2 * (first / columns) + 1) = PATH;
+
+    for (int origin = 0; origin < cells; ++origin) {
+        // Walk until the maze is hit; overwriting exit directions erases the loops
+        int cell = origin;
+        while (!inMaze[cell]) {
+            int cx = cell % columns;
+            int cy = cell / columns;
+            int neighbors[4];
+            int count = 0;
+            for (int dir = 0; dir < 4; ++dir) {
+                int nx = cx + LATTICE_DX[dir];
+                int ny = cy + LATTICE_DY[dir];
+                if (nx >= 0 && nx < columns && ny >= 0 && ny < rows) {
+                    neighbors[count++] = dir;
+                }
+            }
+            int dir = neighbors[uniformBelow(rng, count)];
+            exitDir[cell] = static_cast<std::uint8_t>(dir);
+            cell = (cy + LATTICE_DY[dir]) * columns + cx + LATTICE_DX[dir];
+        }
+
+        // Carve the loop-erased path
+        cell = origin;
+        while (!inMaze[cell]) {
+            int cx = cell % columns;
+            int cy = cell / columns;
+            int dir = exitDir[cell];
+            inMaze[cell] = 1;
+            at(2 * cx + 1, 2 * cy + 1) = PATH;
+            at(2 * cx + 1 + LATTICE_DX[dir], 2 * cy + 1 + LATTICE_DY[dir]) = PATH;
+            cell = (cy + LATTICE_DY[dir]) * columns + cx + LATTICE_DX[dir];
+        }
+    }
+}
+
+// Carve each row in runs of cells joined left to right; every run opens upwards once
+void Maze::generateSidewinder(RandomStream& rng) {
+    const int columns = latticeCells(width);
+    const int rows = latticeCells(height);
+
+    for (int cy = 0; cy < rows; ++cy) {
+        int runStart = 0;
+        for (int cx = 0; cx < columns; ++cx) {
+            at(2 * cx + 1, 2 * cy + 1) = PATH;
+            bool lastColumn = cx + 1 == columns;
+
+            // The top row has nothing above it and is one long corridor
+            if (cy == 0) {
+                if (!lastColumn) {
+                    at(2 * cx + 2, 1) = PATH;
+                }
+                continue;
+            }
+
+            if (lastColumn || uniformBelow(rng, 2) == 0) {
+                int up = runStart + static_cast<int>(uniformBelow(rng, cx - runStart + 1));
+                at(2 * up + 1, 2 * cy) = PATH;
+                runStart = cx + 1;
+            } else {
+                at(2 * cx + 2, 2 * cy + 1) = PATH;
+            }
+        }
+    }
+}
+
+// Start from one open chamber and keep splitting chambers with a wall that has a single gap
+void Maze::generateRecursiveDivision(RandomStream& rng) {
+    struct Chamber { int x, y, columns, rows; };  // In lattice cells
+    const int columns = latticeCells(width);
+    const int rows = latticeCells(height);
+
+    // Open every cell and every wall between lattice neighbours
+    for (int cy = 0; cy < rows; ++cy) {
+        for (int cx = 0; cx < columns; ++cx) {
+            at(2 * cx + 1, 2 * cy + 1) = PATH;
+            if (cx + 1 < columns) {
+                at(2 * cx + 2, 2 * cy + 1) = PATH;
+            }
+            if (cy + 1 < rows) {
+                at(2 * cx + 1, 2 * cy + 2) = PATH;
+            }
+        }
+    }
+
+    std::stack<Chamber> chambers;
+    chambers.push({0, 0, columns, rows});
+    while (!chambers.empty()) {
+        Chamber c = chambers.top();
+        chambers.pop();
+        if (c.columns < 2 || c.rows < 2) {
+            continue;
+        }
+
+        // Split across the longer side so chambers stay roughly square
+        bool horizontal = c.rows > c.columns || (c.rows == c.columns && uniformBelow(rng, 2) == 0);
+        if (horizontal) {
+            int split = 1 + static_cast<int>(uniformBelow(rng, c.rows - 1));
+            int gap = c.x + static_cast<int>(uniformBelow(rng, c.columns));
+            for (int cx = c.x; cx < c.x + c.columns; ++cx) {
+                if (cx != gap) {
+                    at(2 * cx + 1, 2 * (c.y + split)) = WALL;
+                }
+            }
+            chambers.push({c.x, c.y, c.columns, split});
+            chambers.push({c.x, c.y + split, c.columns, c.rows - split});
+        } else {
+            int split = 1 + static_cast<int>(uniformBelow(rng, c.columns - 1));
+            int gap = c.y + static_cast<int>(uniformBelow(rng, c.rows));
+            for (int cy = c.y; cy < c.y + c.rows; ++cy) {
+                if (cy != gap) {
+                    at(2 * (c.x + split), 2 * cy + 1) = WALL;
+                }
+            }
+            chambers.push({c.x, c.y, split, c.rows});
+            chambers.push({c.x + split, c.y, c.columns - split, c.rows});
+        }
+    }
+}
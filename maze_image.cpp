@@ -0,0 +1,133 @@
+#include "maze_image.h"
+#include "image_writer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <utility>
+#ifdef MAZE_WITH_SFML
+#include <SFML/Graphics.hpp>
+#endif
+
+Framebuffer::Framebuffer(int width, int height, Rgba fill)
+    : width(width), height(height), pixels(static_cast<std::size_t>(width) * height, fill) { }
+
+void renderCells(const MazeView& maze, int cellSize, Framebuffer& frame) {
+    renderBands(maze.getWidth(), maze.getHeight(), cellSize, frame,
+                [&](int x, int y) { return CELL_COLORS[maze(x, y)]; });
+}
+
+void renderHeatmap(const MazeView& maze, const VisitCounts& visits, int cellSize, Framebuffer& frame) {
+    if (visits.empty()) {
+        renderCells(maze, cellSize, frame);
+        return;
+    }
+
+    constexpr Rgba LIGHT = { 198, 219, 239, 255 };
+    constexpr Rgba DARK = { 8, 48, 107, 255 };
+
+    // Shades for log(visits) / log(max visits), so a lookup replaces the blend per cell
+    Rgba shades[256];
+    for (int i = 0; i < 256; ++i) {
+        auto blend = [i](std::uint8_t light, std::uint8_t dark) {
+            return static_cast<std::uint8_t>(light + (dark - light) * i / 255);
+        };
+        shades[i] = { blend(LIGHT.r, DARK.r), blend(LIGHT.g, DARK.g), blend(LIGHT.b, DARK.b), 255 };
+    }
+    const double logMax = std::log(static_cast<double>(std::max<std::uint64_t>(visits.max(), 2)));
+
+    renderBands(maze.getWidth(), maze.getHeight(), cellSize, frame, [&](int x, int y) {
+        std::uint8_t type = maze(x, y);
+        std::uint64_t count = visits(x, y);
+        if (type != Maze::PATH || count == 0) {
+            return CELL_COLORS[type];
+        }
+        return shades[static_cast<int>(std::log(static_cast<double>(count)) / logMax * 255.0)];
+    });
+}
+
+void drawDots(const std::vector<Trajectory>& paths, int cellSize, int radius, Rgba color, Framebuffer& frame) {
+    // Offsets of the pixels inside the dot, computed once
+    std::vector<std::pair<int, int>> dot;
+    for (int dy = -radius; dy <= radius; ++dy) {
+        for (int dx = -radius; dx <= radius; ++dx) {
+            if (dx * dx + dy * dy <= radius * radius) {
+                dot.emplace_back(dx, dy);
+            }
+        }
+    }
+
+    for (const auto& path : paths) {
+        for (const auto& point : path) {
+            int px = point.first * cellSize + cellSize / 2;
+            int py = point.second * cellSize + cellSize / 2;
+
+            // Only dots touching the image edge need clipping
+            if (frame.contains(px - radius, py - radius) && frame.contains(px + radius, py + radius)) {
+                for (const auto& offset : dot) {
+                    frame.set(px + offset.first, py + offset.second, color);
+                }
+            } else {
+                for (const auto& offset : dot) {
+                    if (frame.contains(px + offset.first, py + offset.second)) {
+                        frame.set(px + offset.first, py + offset.second, color);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void drawPath(const Trajectory& path, int cellSize, Rgba color, Framebuffer& frame) {
+    if (path.empty()) {
+        return;
+    }
+
+    auto previous = path.begin();
+    for (auto current = std::next(previous); current != path.end(); previous = current++) {
+        int x1 = previous->first * cellSize + cellSize / 2;
+        int y1 = previous->second * cellSize + cellSize / 2;
+        int x2 = current->first * cellSize + cellSize / 2;
+        int y2 = current->second * cellSize + cellSize / 2;
+
+        // Bresenham line between the two centres
+        int dx = std::abs(x2 - x1);
+        int dy = std::abs(y2 - y1);
+        int sx = (x1 < x2) ? 1 : -1;
+        int sy = (y1 < y2) ? 1 : -1;
+        int err = dx - dy;
+
+        while (true) {
+            if (frame.contains(x1, y1)) {
+                frame.set(x1, y1, color);
+            }
+            if (x1 == x2 && y1 == y2) break;
+            int e2 = 2 * err;
+            if (e2 > -dy) { err -= dy; x1 += sx; }
+            if (e2 < dx) { err += dx; y1 += sy; }
+        }
+    }
+}
+
+bool saveFramebuffer(const Framebuffer& frame, const std::string& filename) {
+    ImageFormat format;
+    if (imageFormatOf(filename, format)) {
+        return writeImage(frame, filename, format);
+    }
+
+#ifdef MAZE_WITH_SFML
+    // Formats without a built-in writer go through SFML
+    sf::Image image;
+    image.create(frame.getWidth(), frame.getHeight(), frame.bytes());
+    if (!image.saveToFile(filename)) {
+        std::cerr << "Failed to save maze image to: " << filename << std::endl;
+        return false;
+    }
+    return true;
+#else
+    std::cerr << "Unsupported image format without SFML: " << filename << std::endl;
+    return false;
+#endif
+}
@@ -0,0 +1,94 @@
+#ifndef MAZE_IMAGE_H
+#define MAZE_IMAGE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "maze.h"
+#include "trajectory.h"
+#include "visit_counts.h"
+
+// One RGBA pixel, laid out the way image encoders expect it
+struct Rgba {
+    std::uint8_t r, g, b, a;
+};
+
+static_assert(sizeof(Rgba) == 4, "Pixels must be packed RGBA bytes");
+
+// Colours of the maze images
+constexpr Rgba BLACK = { 0, 0, 0, 255 };
+constexpr Rgba WHITE = { 255, 255, 255, 255 };
+constexpr Rgba GREEN = { 0, 255, 0, 255 };
+constexpr Rgba RED = { 255, 0, 0, 255 };
+constexpr Rgba BLUE = { 0, 0, 255, 255 };
+
+// Colour of each cell type, indexed by Maze::CellType
+constexpr Rgba CELL_COLORS[4] = { BLACK, WHITE, GREEN, RED };
+
+// Row-major RGBA pixel buffer that images are rendered into before being encoded once
+class Framebuffer {
+public:
+    Framebuffer(int width, int height, Rgba fill = WHITE);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    Rgba* row(int y) { return pixels.data() + static_cast<std::size_t>(y) * width; }
+    const Rgba* row(int y) const { return pixels.data() + static_cast<std::size_t>(y) * width; }
+
+    bool contains(int x, int y) const { return x >= 0 && y >= 0 && x < width && y < height; }
+
+    // Unchecked pixel write; callers clip with contains() where needed
+    void set(int x, int y, Rgba color) { row(y)[x] = color; }
+
+    // The pixels as width * height * 4 bytes
+    const std::uint8_t* bytes() const { return reinterpret_cast<const std::uint8_t*>(pixels.data()); }
+
+private:
+    int width;
+    int height;
+    std::vector<Rgba> pixels;
+};
+
+// Fill a width x height grid of cellSize x cellSize squares with cellColor(x, y). Each row of
+// squares is rendered as one pixel row and copied down the rest of its band; bands are
+// rendered in parallel.
+template <typename CellColor>
+void renderBands(int width, int height, int cellSize, Framebuffer& frame, CellColor cellColor) {
+    const std::size_t rowBytes = static_cast<std::size_t>(frame.getWidth()) * sizeof(Rgba);
+
+#pragma omp parallel for schedule(static)
+    for (int y = 0; y < height; ++y) {
+        Rgba* first = frame.row(y * cellSize);
+        for (int x = 0; x < width; ++x) {
+            std::fill_n(first + x * cellSize, cellSize, cellColor(x, y));
+        }
+        for (int dy = 1; dy < cellSize; ++dy) {
+            std::memcpy(frame.row(y * cellSize + dy), first, rowBytes);
+        }
+    }
+}
+
+// Draw every cell as a cellSize x cellSize square with renderBands
+void renderCells(const MazeView& maze, int cellSize, Framebuffer& frame);
+
+// Draw open cells shaded by how often they were visited, on a log scale from light blue for
+// one visit to dark blue for the most visited cell. Walls, unvisited cells, the start and the
+// exit keep their usual colours. One pass over the cells, rendered like renderCells.
+void renderHeatmap(const MazeView& maze, const VisitCounts& visits, int cellSize, Framebuffer& frame);
+
+// Draw a dot of the given radius at the centre of every cell visited by the paths
+void drawDots(const std::vector<Trajectory>& paths, int cellSize, int radius, Rgba color, Framebuffer& frame);
+
+// Draw a line through the centres of the cells of a path
+void drawPath(const Trajectory& path, int cellSize, Rgba color, Framebuffer& frame);
+
+// Encode the pixels into an image file whose format follows the extension: PNG, PPM, PGM and
+// BMP use the built-in writers (image_writer.h), anything else needs a build with SFML.
+// Reports failures on std::cerr.
+bool saveFramebuffer(const Framebuffer& frame, const std::string& filename);
+
+#endif // MAZE_IMAGE_H
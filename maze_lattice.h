@@ -0,0 +1,32 @@
+#ifndef MAZE_LATTICE_H
+#define MAZE_LATTICE_H
+
+// Perfect-maze generators carve a lattice of cells at odd coordinates 1, 3, 5, ... that stay
+// inside the wall border; the even coordinates in between hold the walls or openings that
+// link neighbouring cells.
+
+// Lattice cells along an axis of the given size
+inline int latticeCells(int size) {
+    return (size - 1) / 2;
+}
+
+// Lattice coordinate closest to v on an axis of the given size
+inline int nearestLatticeCoordinate(int v, int size) {
+    int lattice = (v % 2 == 1) ? v : v - 1;
+    int last = 2 * latticeCells(size) - 1;
+    return lattice < 1 ? 1 : (lattice > last ? last : lattice);
+}
+
+// True if (x, y) lies on the short L-shaped corridor joining the point (px, py) to its
+// nearest lattice cell: first along the row of the point, then along the lattice column.
+// Generators open these cells so start and exit positions off the lattice stay reachable.
+inline bool onLatticeConnector(int px, int py, int x, int y, int width, int height) {
+    int ox = nearestLatticeCoordinate(px, width);
+    int oy = nearestLatticeCoordinate(py, height);
+    if (y == py && ((x >= ox && x <= px) || (x <= ox && x >= px))) {
+        return true;
+    }
+    return x == ox && ((y >= oy && y <= py) || (y <= oy && y >= py));
+}
+
+#endif // MAZE_LATTICE_H
@@ -0,0 +1,128 @@
+#include "maze.h"
+#include "maze_text.h"
+#include "mapped_file.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <iomanip>
+#include <utility>
+
+// The original loader: one operator>> per cell. Returns false on malformed input.
+bool loadWithIostream(const std::string& path, std::vector<std::uint8_t>& cells, int& width, int& height) {
+    std::ifstream file(path);
+    if (!file || !(file >> height >> width) || height <= 0 || width <= 0) {
+        return false;
+    }
+    cells.resize(static_cast<size_t>(width) * height);
+    for (auto& cell : cells) {
+        int value;
+        if (!(file >> value) || value < Maze::WALL || value > Maze::EXIT) {
+            return false;
+        }
+        cell = static_cast<std::uint8_t>(value);
+    }
+    return true;
+}
+
+// The mapped parser behind Maze::loadFromFile, into the same unpadded layout
+bool loadWithParser(const std::string& path, std::vector<std::uint8_t>& cells, int& width, int& height) {
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+    const char* end = file.data() + file.size();
+    const char* begin = parseTextHeader(file.data(), end, height, width);
+    if (!begin) {
+        return false;
+    }
+    cells.resize(static_cast<size_t>(width) * height);
+    long long startCell, exitCell;
+    return parseTextCells(begin, end, width, height, cells.data(), width, startCell, exitCell) == TextParseError::NONE;
+}
+
+// Hand-written files with whitespace the fast path does not expect, on rows that are a
+// multiple of four cells wide; both parsers must read the same cells from each
+bool checkLayouts() {
+    const std::pair<const char*, const char*> layouts[] = {
+        {"double_space", "2 8\n1 1 1 1  1 1 1 1\n1 2 0 0 0 0  3 1\n"},
+        {"tab", "2 8\n1 1 1 1 \t1 1 1 1\n1 2 0 0\t0 0 3 1\n"},
+        {"trailing_space", "2 8\n1 1 1 1 1 1 1 1 \n1 2 0 0 0 0 3 1 \n"},
+    };
+
+    bool agree = true;
+    for (const auto& layout : layouts) {
+        std::string path = "../input/load_layout_" + std::string(layout.first) + ".txt";
+        std::ofstream(path) << layout.second;
+
+        std::vector<std::uint8_t> reference, parsed;
+        int width = 0, height = 0, parsedWidth = 0, parsedHeight = 0;
+        bool referenceLoaded = loadWithIostream(path, reference, width, height);
+        bool loaded = loadWithParser(path, parsed, parsedWidth, parsedHeight);
+        if (!referenceLoaded || !loaded || width != parsedWidth || height != parsedHeight || reference != parsed) {
+            std::cerr << "Parsers disagree on the " << layout.first << " layout" << std::endl;
+            agree = false;
+        }
+    }
+    return agree;
+}
+
+int main() {
+    std::vector<int> sizes = {1024, 4096, 16384};
+    const std::uint64_t seed = 12345;
+
+    if (!checkLayouts()) {
+        return 1;
+    }
+
+    std::cout << std::fixed;
+    std::ofstream csvFile("../output/load_times.csv");
+    csvFile << "Size,Parser,Time (seconds),Cells per second\n" << std::fixed;
+
+    for (int size : sizes) {
+        std::string filename = "load_bench_" + std::to_string(size) + ".txt";
+        {
+            Maze maze;
+            maze.initialize(size, size, 1, 1, size - 2, size - 2, seed, Maze::SIDEWINDER);
+            if (!maze.saveToFile(filename)) {
+                continue;
+            }
+        }
+
+        // Both parsers fill a plain byte grid, so only parsing is compared
+        std::vector<std::uint8_t> reference, parsed;
+        int width = 0, height = 0, parsedWidth = 0, parsedHeight = 0;
+        auto startTime = std::chrono::high_resolution_clock::now();
+        bool referenceLoaded = loadWithIostream("../input/" + filename, reference, width, height);
+        auto endTime = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> iostreamTime = endTime - startTime;
+
+        startTime = std::chrono::high_resolution_clock::now();
+        bool loaded = loadWithParser("../input/" + filename, parsed, parsedWidth, parsedHeight);
+        endTime = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> parserTime = endTime - startTime;
+
+        if (!referenceLoaded || !loaded) {
+            std::cerr << "Failed to load maze from file: " << filename << std::endl;
+            continue;
+        }
+        if (width != parsedWidth || height != parsedHeight || reference != parsed) {
+            std::cerr << "Parsers disagree on " << filename << std::endl;
+        }
+
+        double cells = static_cast<double>(size) * size;
+        const char* names[2] = {"iostream", "mapped"};
+        double times[2] = {iostreamTime.count(), parserTime.count()};
+        for (int i = 0; i < 2; ++i) {
+            std::cout << size << "x" << size << " " << names[i] << ": " << std::setprecision(4) << times[i]
+                      << " seconds, " << std::setprecision(0) << cells / times[i] << " cells/second" << std::endl;
+            csvFile << size << "," << names[i] << "," << std::setprecision(6) << times[i] << ","
+                    << std::setprecision(0) << cells / times[i] << "\n";
+        }
+        std::cout << "Speedup: " << std::setprecision(1) << times[0] / times[1] << "x" << std::endl;
+    }
+
+    csvFile.close();
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include "maze_pyramid.h"
+#include "maze_image.h"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Open fraction of every block of a downsampled level, from 0 (all walls) to 255 (all open)
+struct PyramidLevel {
+    int width = 0;
+    int height = 0;
+    std::vector<std::uint8_t> open;
+
+    std::uint8_t operator()(int x, int y) const { return open[static_cast<std::size_t>(y) * width + x]; }
+};
+
+// Level 1 straight from the cells
+PyramidLevel reduceCells(const MazeView& maze) {
+    PyramidLevel level;
+    level.width = (maze.getWidth() + 1) / 2;
+    level.height = (maze.getHeight() + 1) / 2;
+    level.open.resize(static_cast<std::size_t>(level.width) * level.height);
+
+#pragma omp parallel for schedule(static)
+    for (int y = 0; y < level.height; ++y) {
+        for (int x = 0; x < level.width; ++x) {
+            int open = 0, cells = 0;
+            for (int cy = 2 * y; cy < std::min(2 * y + 2, maze.getHeight()); ++cy) {
+                for (int cx = 2 * x; cx < std::min(2 * x + 2, maze.getWidth()); ++cx) {
+                    open += maze(cx, cy) != Maze::WALL;
+                    ++cells;
+                }
+            }
+            std::size_t index = static_cast<std::size_t>(y) * level.width + x;
+            level.open[index] = static_cast<std::uint8_t>((255 * open + cells / 2) / cells);
+        }
+    }
+    return level;
+}
+
+// The next level from the one before; blocks outside the maze are left out of the average
+PyramidLevel reduceLevel(const PyramidLevel& previous) {
+    PyramidLevel level;
+    level.width = (previous.width + 1) / 2;
+    level.height = (previous.height + 1) / 2;
+    level.open.resize(static_cast<std::size_t>(level.width) * level.height);
+
+#pragma omp parallel for schedule(static)
+    for (int y = 0; y < level.height; ++y) {
+        for (int x = 0; x < level.width; ++x) {
+            int sum = 0, blocks = 0;
+            for (int by = 2 * y; by < std::min(2 * y + 2, previous.height); ++by) {
+                for (int bx = 2 * x; bx < std::min(2 * x + 2, previous.width); ++bx) {
+                    sum += previous(bx, by);
+                    ++blocks;
+                }
+            }
+            std::size_t index = static_cast<std::size_t>(y) * level.width + x;
+            level.open[index] = static_cast<std::uint8_t>((sum + blocks / 2) / blocks);
+        }
+    }
+    return level;
+}
+
+// Render and write every tile of one level. blockColor(x, y) gives the colour of a block
+// (a cell at level 0) of a width x height grid.
+template <typename BlockColor>
+bool writeLevel(const std::string& directory, int level, int width, int height,
+                const PyramidOptions& options, BlockColor blockColor) {
+    const int blocksPerTile = std::max(1, options.tileSize / options.cellSize);
+    const int columns = (width + blocksPerTile - 1) / blocksPerTile;
+    const int rows = (height + blocksPerTile - 1) / blocksPerTile;
+    const std::string levelDirectory = directory + "/" + std::to_string(level);
+    std::error_code error;
+    fs::create_directories(levelDirectory, error);
+    if (error) {
+        std::cerr << "Unable to create directory: " << levelDirectory << std::endl;
+        return false;
+    }
+
+    std::atomic<bool> ok{true};
+#pragma omp parallel for schedule(dynamic)
+    for (long long t = 0; t < static_cast<long long>(columns) * rows; ++t) {
+        int column = static_cast<int>(t % columns);
+        int row = static_cast<int>(t / columns);
+        int firstX = column * blocksPerTile;
+        int firstY = row * blocksPerTile;
+        int tileWidth = std::min(blocksPerTile, width - firstX);
+        int tileHeight = std::min(blocksPerTile, height - firstY);
+
+        Framebuffer frame(tileWidth * options.cellSize, tileHeight * options.cellSize);
+        renderBands(tileWidth, tileHeight, options.cellSize, frame,
+                    [&](int x, int y) { return blockColor(firstX + x, firstY + y); });
+        std::string filename = levelDirectory + "/" + std::to_string(column) + "_" + std::to_string(row) + ".png";
+        if (!saveFramebuffer(frame, filename)) {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+} // namespace
+
+bool writeImagePyramid(const MazeView& maze, int startX, int startY, int exitX, int exitY,
+                       const std::string& directory, const PyramidOptions& options) {
+    std::error_code error;
+    fs::create_directories(directory, error);
+    std::ofstream index(directory + "/levels.csv");
+    if (!index) {
+        std::cerr << "Unable to open file for writing: " << directory << "/levels.csv" << std::endl;
+        return false;
+    }
+    index << "Level,Cells per block,Blocks wide,Blocks high,Tile columns,Tile rows\n";
+
+    const int blocksPerTile = std::max(1, options.tileSize / options.cellSize);
+    auto record = [&](int level, int width, int height) {
+        index << level << "," << (1LL << level) << "," << width << "," << height << ","
+              << (width + blocksPerTile - 1) / blocksPerTile << "," << (height + blocksPerTile - 1) / blocksPerTile << "\n";
+    };
+
+    // Level 0: every cell in its own colour
+    bool ok = writeLevel(directory, 0, maze.getWidth(), maze.getHeight(), options,
+                         [&](int x, int y) { return CELL_COLORS[maze(x, y)]; });
+    record(0, maze.getWidth(), maze.getHeight());
+
+    // Halve until a level fits in one tile; only the level being written and the one it is
+    // reduced from are alive
+    PyramidLevel level;
+    int width = maze.getWidth();
+    int height = maze.getHeight();
+    for (int l = 1; ok && (width > blocksPerTile || height > blocksPerTile); ++l) {
+        level = l == 1 ? reduceCells(maze) : reduceLevel(level);
+        width = level.width;
+        height = level.height;
+        ok = writeLevel(directory, l, level.width, level.height, options, [&](int x, int y) {
+            if (x == startX >> l && y == startY >> l) {
+                return CELL_COLORS[Maze::START];
+            }
+            if (x == exitX >> l && y == exitY >> l) {
+                return CELL_COLORS[Maze::EXIT];
+            }
+            std::uint8_t open = level(x, y);
+            if (options.filter == PyramidFilter::MAJORITY) {
+                return open >= 128 ? WHITE : BLACK;
+            }
+            return Rgba{ open, open, open, 255 };
+        });
+        record(l, level.width, level.height);
+    }
+    return ok;
+}
@@ -0,0 +1,31 @@
+#ifndef MAZE_PYRAMID_H
+#define MAZE_PYRAMID_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "maze.h"
+
+// How a block of cells is reduced to one colour in the downsampled levels
+enum class PyramidFilter {
+    BOX,       // Grey level proportional to the fraction of open cells
+    MAJORITY   // White if at least half of the cells are open, black otherwise
+};
+
+// Layout of an image pyramid
+struct PyramidOptions {
+    int cellSize = 4;     // Pixels per cell at level 0, per block of cells at the other levels
+    int tileSize = 256;   // Pixels per tile side; edge tiles are cropped
+    PyramidFilter filter = PyramidFilter::BOX;
+};
+
+// Write a tiled image pyramid of the maze under `directory`. Level 0 draws every cell; each
+// level after it draws blocks of 2 x 2 blocks of the level before, so it has half the size,
+// until a level fits in one tile. Tile (column, row) of level L is <directory>/L/column_row.png,
+// and levels.csv lists the tile grid of every level. The start and exit stay marked at every
+// level. Only the open fractions of the downsampled levels are held in memory (a third of a
+// byte per cell); tiles are rendered in parallel and written as soon as they are done.
+bool writeImagePyramid(const MazeView& maze, int startX, int startY, int exitX, int exitY,
+                       const std::string& directory, const PyramidOptions& options = PyramidOptions());
+
+#endif // MAZE_PYRAMID_H
@@ -0,0 +1,60 @@
+#include "maze_stream.h"
+#include "maze_text.h"
+#include <iostream>
+
+TextRowSink::TextRowSink(const std::string& path) : path(path), file(nullptr), width(0) { }
+
+TextRowSink::~TextRowSink() {
+    if (file) {
+        std::fclose(file);
+    }
+}
+
+bool TextRowSink::begin(int width, int height) {
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Unable to open file for writing: " << path << std::endl;
+        return false;
+    }
+    // Large stdio buffer so rows leave in big sequential writes
+    std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+
+    this->width = width;
+    line.resize(2 * static_cast<size_t>(width));
+    return std::fprintf(file, "%d %d\n", height, width) > 0;
+}
+
+bool TextRowSink::writeRow(const std::uint8_t* cells) {
+    formatTextRow(cells, width, line.data());
+    return std::fwrite(line.data(), 1, line.size(), file) == line.size();
+}
+
+bool TextRowSink::end() {
+    bool ok = std::fclose(file) == 0;
+    file = nullptr;
+    if (!ok) {
+        std::cerr << "Error writing maze file: " << path << std::endl;
+    }
+    return ok;
+}
+
+HashingRowSink::HashingRowSink(MazeRowSink& target) : target(target), width(0), hash(FNV_OFFSET) { }
+
+bool HashingRowSink::begin(int width, int height) {
+    this->width = width;
+    hash = hashDimensions(width, height);
+    return target.begin(width, height);
+}
+
+bool HashingRowSink::writeRow(const std::uint8_t* cells) {
+    hash = fnv1a(hash, cells, width);
+    return target.writeRow(cells);
+}
+
+bool HashingRowSink::end() {
+    return target.end();
+}
+
+std::uint64_t HashingRowSink::getHash() const {
+    return hash;
+}
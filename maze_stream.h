@@ -0,0 +1,75 @@
+#ifndef MAZE_STREAM_H
+#define MAZE_STREAM_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// FNV-1a content hash of a maze: its height and width as 32-bit little-endian words, then
+// every cell type row by row. Stored and streamed mazes with the same cells hash the same.
+constexpr std::uint64_t FNV_OFFSET = 14695981039346656037ull;
+constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+inline std::uint64_t fnv1a(std::uint64_t hash, const std::uint8_t* bytes, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+inline std::uint64_t hashDimensions(int width, int height) {
+    std::uint8_t bytes[8];
+    for (int i = 0; i < 4; ++i) {
+        bytes[i] = static_cast<std::uint8_t>(static_cast<std::uint32_t>(height) >> (8 * i));
+        bytes[4 + i] = static_cast<std::uint8_t>(static_cast<std::uint32_t>(width) >> (8 * i));
+    }
+    return fnv1a(FNV_OFFSET, bytes, sizeof(bytes));
+}
+
+// Receives a maze one row of cell types at a time, top to bottom, so generators can
+// produce mazes far larger than memory.
+class MazeRowSink {
+public:
+    virtual ~MazeRowSink() = default;
+
+    virtual bool begin(int width, int height) = 0;
+    virtual bool writeRow(const std::uint8_t* cells) = 0;
+    virtual bool end() = 0;
+};
+
+// Writes rows in the text format read by Maze::loadFromFile
+class TextRowSink : public MazeRowSink {
+public:
+    explicit TextRowSink(const std::string& path);
+    ~TextRowSink() override;
+
+    bool begin(int width, int height) override;
+    bool writeRow(const std::uint8_t* cells) override;
+    bool end() override;
+
+private:
+    std::string path;
+    std::FILE* file;
+    int width;
+    std::vector<char> line;    // One formatted row
+};
+
+// Passes rows on to another sink while hashing them
+class HashingRowSink : public MazeRowSink {
+public:
+    explicit HashingRowSink(MazeRowSink& target);
+
+    bool begin(int width, int height) override;
+    bool writeRow(const std::uint8_t* cells) override;
+    bool end() override;
+
+    std::uint64_t getHash() const;
+
+private:
+    MazeRowSink& target;
+    int width;
+    std::uint64_t hash;
+};
+
+#endif // MAZE_STREAM_H
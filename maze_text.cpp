@@ -0,0 +1,262 @@
+#include "maze_text.h"
+#include "maze.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Bytes of input per parallel range
+const size_t RANGE_BYTES = 1 << 22;
+
+// Bytes of output per formatted block of rows, and blocks formatted before they are written
+const size_t BLOCK_BYTES = 1 << 22;
+const int BATCH_BLOCKS = 8;
+
+// Same characters as std::isspace in the C locale, which operator>> skips
+inline bool isSpace(char c) {
+    return (c == ' ') | (static_cast<unsigned char>(c - '\t') <= '\r' - '\t');
+}
+
+// A byte range of the cell data; ranges start at whitespace so no token is split
+struct TextRange {
+    const char* begin;
+    const char* end;
+    long long tokens;       // Tokens that start in the range
+    long long firstToken;   // Index of the first of them
+    TextParseError error;   // First bad token in the range, if any
+    long long startCell;
+    long long exitCell;
+};
+
+// Bit 7 of each byte of the little-endian word x set where the byte is whitespace (isSpace)
+inline std::uint64_t spaceMask(std::uint64_t x) {
+    const std::uint64_t ones = 0x0101010101010101ull;
+    const std::uint64_t high = 0x8080808080808080ull;
+
+    // '\t' to '\r': at least 9 and below 14, among ASCII bytes
+    std::uint64_t atLeast9 = ((x | high) - 9 * ones) & high;
+    std::uint64_t below14 = ~((x | high) - 14 * ones) & high;
+    std::uint64_t control = atLeast9 & below14 & ~x;
+
+    // ' ': bytes of x ^ 0x20... that are zero
+    std::uint64_t y = x ^ (0x20 * ones);
+    std::uint64_t blank = ~(((y & ~high) + ~high) | y | ~high);
+    return control | blank;
+}
+
+// Tokens starting in [begin, end), which starts at whitespace or at the start of the cells.
+// Eight bytes at a time: a token starts at a non-space byte that follows a space byte.
+long long countTokens(const char* begin, const char* end) {
+    const std::uint64_t high = 0x8080808080808080ull;
+    const size_t length = static_cast<size_t>(end - begin);
+    long long tokens = 0;
+    std::uint64_t previous = high;  // As if the range were preceded by whitespace
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, begin + i, sizeof(word));
+        std::uint64_t spaces = spaceMask(word);
+        std::uint64_t afterSpace = (spaces << 8) | (previous >> 56);
+        tokens += __builtin_popcountll(~spaces & high & afterSpace);
+        previous = spaces;
+    }
+    bool afterSpace = (previous >> 63) != 0;
+    for (; i < length; ++i) {
+        bool space = isSpace(begin[i]);
+        tokens += !space && afterSpace;
+        afterSpace = space;
+    }
+    return tokens;
+}
+
+// Four single-digit cells in the canonical "d d d d " layout, read as one little-endian word.
+// Returns false, leaving the caller to the general path, if the bytes are laid out otherwise
+// or hold a START or EXIT cell.
+inline bool parseFourCells(const char* p, std::uint32_t& values) {
+    std::uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    const std::uint64_t digitLanes = 0x00FF00FF00FF00FFull;
+    std::uint64_t digits = (word & digitLanes) ^ 0x0030003000300030ull;
+    if ((word & ~digitLanes) != 0x2000200020002000ull || (digits & 0x00FE00FE00FE00FEull) != 0) {
+        return false;
+    }
+    values = static_cast<std::uint32_t>((digits & 0xFF) | ((digits >> 8) & 0xFF00) |
+                                        ((digits >> 16) & 0xFF0000) | ((digits >> 24) & 0xFF000000));
+    return true;
+}
+
+// Parse the tokens of a range into their cells, stopping at the first bad token or at the last cell
+void parseRange(TextRange& range, int width, long long cellCount, std::uint8_t* cells, int stride) {
+    long long token = range.firstToken;
+    int x = static_cast<int>(token % width);
+    long long y = token / width;
+    const char* p = range.begin;
+
+    while (token < cellCount) {
+        while (p < range.end && isSpace(*p)) {
+            ++p;
+        }
+
+        // Fast path: walls and paths four at a time within a row
+        std::uint32_t four;
+        while (range.end - p >= 8 && x + 4 <= width && cellCount - token >= 4 && parseFourCells(p, four)) {
+            std::memcpy(cells + y * stride + x, &four, sizeof(four));
+            token += 4;
+            x += 4;
+            if (x == width) {
+                x = 0;
+                ++y;
+            }
+            p += 8;
+        }
+        if (p == range.end || token == cellCount) {
+            break;
+        }
+        if (isSpace(*p)) {
+            // The fast path stopped on extra whitespace after a group
+            continue;
+        }
+        const char* tokenEnd = p;
+        while (tokenEnd < range.end && !isSpace(*tokenEnd)) {
+            ++tokenEnd;
+        }
+
+        // Cells are almost always a single digit
+        int value;
+        if (tokenEnd - p == 1 && *p >= '0' && *p <= '9') {
+            value = *p - '0';
+        } else {
+            auto result = std::from_chars(p, tokenEnd, value);
+            if (result.ec != std::errc() || result.ptr != tokenEnd) {
+                range.error = TextParseError::READ;
+                return;
+            }
+        }
+        if (value < Maze::WALL || value > Maze::EXIT) {
+            range.error = TextParseError::VALUE;
+            return;
+        }
+
+        cells[y * stride + x] = static_cast<std::uint8_t>(value);
+        if (value == Maze::START) {
+            range.startCell = token;
+        } else if (value == Maze::EXIT) {
+            range.exitCell = token;
+        }
+        ++token;
+        if (++x == width) {
+            x = 0;
+            ++y;
+        }
+        p = tokenEnd;
+    }
+}
+
+} // namespace
+
+const char* parseTextHeader(const char* begin, const char* end, int& height, int& width) {
+    int* fields[2] = { &height, &width };
+    const char* p = begin;
+    for (int* field : fields) {
+        while (p < end && isSpace(*p)) {
+            ++p;
+        }
+        auto result = std::from_chars(p, end, *field);
+        if (result.ec != std::errc() || *field <= 0) {
+            return nullptr;
+        }
+        p = result.ptr;
+    }
+    return p;
+}
+
+TextParseError parseTextCells(const char* begin, const char* end, int width, int height,
+                              std::uint8_t* cells, int stride, long long& startCell, long long& exitCell) {
+    const long long cellCount = static_cast<long long>(width) * height;
+
+    // Cut the input into ranges that start at whitespace
+    std::vector<TextRange> ranges;
+    const char* p = begin;
+    while (p < end) {
+        const char* rangeEnd = end - p > static_cast<std::ptrdiff_t>(RANGE_BYTES) ? p + RANGE_BYTES : end;
+        while (rangeEnd < end && !isSpace(*rangeEnd)) {
+            ++rangeEnd;
+        }
+        ranges.push_back({p, rangeEnd, 0, 0, TextParseError::NONE, -1, -1});
+        p = rangeEnd;
+    }
+    const int count = static_cast<int>(ranges.size());
+
+    // Count tokens per range so every range knows the index of its first cell
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; ++i) {
+        ranges[i].tokens = countTokens(ranges[i].begin, ranges[i].end);
+    }
+    long long tokens = 0;
+    for (auto& range : ranges) {
+        range.firstToken = tokens;
+        tokens += range.tokens;
+    }
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < count; ++i) {
+        if (ranges[i].firstToken < cellCount) {
+            parseRange(ranges[i], width, cellCount, cells, stride);
+        }
+    }
+
+    startCell = -1;
+    exitCell = -1;
+    for (const auto& range : ranges) {
+        // Ranges are in token order, so the first failing range holds the first bad token
+        if (range.error != TextParseError::NONE) {
+            return range.error;
+        }
+        startCell = std::max(startCell, range.startCell);
+        exitCell = std::max(exitCell, range.exitCell);
+    }
+    return tokens < cellCount ? TextParseError::READ : TextParseError::NONE;
+}
+
+void formatTextRow(const std::uint8_t* cells, int width, char* out) {
+    for (int x = 0; x < width; ++x) {
+        out[2 * x] = static_cast<char>('0' + (cells[x] & 3));
+        out[2 * x + 1] = ' ';
+    }
+    out[2 * static_cast<size_t>(width) - 1] = '\n';
+}
+
+bool writeTextCells(std::FILE* file, const std::uint8_t* cells, int width, int height, int stride) {
+    const size_t rowBytes = 2 * static_cast<size_t>(width);
+    const int blockRows = static_cast<int>(std::max<size_t>(1, BLOCK_BYTES / rowBytes));
+    const int blocks = (height + blockRows - 1) / blockRows;
+    std::vector<std::vector<char>> buffers(std::min(blocks, BATCH_BLOCKS));
+    for (auto& buffer : buffers) {
+        buffer.resize(rowBytes * blockRows);
+    }
+
+    for (int firstBlock = 0; firstBlock < blocks; firstBlock += BATCH_BLOCKS) {
+        const int batch = std::min(BATCH_BLOCKS, blocks - firstBlock);
+
+#pragma omp parallel for schedule(static)
+        for (int i = 0; i < batch; ++i) {
+            int firstRow = (firstBlock + i) * blockRows;
+            int lastRow = std::min(height, firstRow + blockRows);
+            for (int y = firstRow; y < lastRow; ++y) {
+                formatTextRow(cells + static_cast<size_t>(y) * stride, width,
+                              buffers[i].data() + (y - firstRow) * rowBytes);
+            }
+        }
+
+        for (int i = 0; i < batch; ++i) {
+            int firstRow = (firstBlock + i) * blockRows;
+            size_t bytes = (std::min(height, firstRow + blockRows) - firstRow) * rowBytes;
+            if (std::fwrite(buffers[i].data(), 1, bytes, file) != bytes) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
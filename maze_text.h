@@ -0,0 +1,37 @@
+#ifndef MAZE_TEXT_H
+#define MAZE_TEXT_H
+
+#include <cstdint>
+#include <cstdio>
+
+// The text maze format is "height width" followed by height x width whitespace-separated
+// cell values, row by row.
+
+// What went wrong while parsing the cells of a text maze
+enum class TextParseError {
+    NONE,
+    READ,   // A token is not a number, or the input ends early
+    VALUE   // A number is not a cell type
+};
+
+// Parse the two dimensions at the start of [begin, end). Returns where the cells begin, or
+// nullptr if the header does not hold two positive numbers.
+const char* parseTextHeader(const char* begin, const char* end, int& height, int& width);
+
+// Parse width x height cells from [begin, end) into rows `stride` bytes apart. Large inputs
+// are cut into byte ranges whose tokens are counted, then parsed, in parallel; the error
+// reported is the one a token-by-token reader would hit first. startCell and exitCell get the
+// row-major index of the last START and EXIT cell, or -1.
+TextParseError parseTextCells(const char* begin, const char* end, int width, int height,
+                              std::uint8_t* cells, int stride, long long& startCell, long long& exitCell);
+
+// Format one row as "d d ... d\n" into out, which holds 2 * width characters. Only the type
+// bits of each cell are written, so padded grid cells can be passed as they are.
+void formatTextRow(const std::uint8_t* cells, int width, char* out);
+
+// Write width x height cells, rows `stride` bytes apart, after the header has been written.
+// Blocks of rows are formatted into preallocated buffers, in parallel for large mazes, and
+// leave in large sequential writes; the bytes are the same as formatting cell by cell.
+bool writeTextCells(std::FILE* file, const std::uint8_t* cells, int width, int height, int stride);
+
+#endif // MAZE_TEXT_H
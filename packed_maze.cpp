@@ -0,0 +1,119 @@
+#include "packed_maze.h"
+#include <cstring>
+#include <iostream>
+
+void PackedMazeView::unpackRow(int y, std::uint8_t* out) const {
+    const std::uint8_t* row = cells + y * rowBytes;
+    for (int x = 0; x < width; ++x) {
+        out[x] = (row[x >> 2] >> ((x & 3) * 2)) & 3;
+    }
+}
+
+void packRow(const std::uint8_t* cells, int width, std::uint8_t* out) {
+    std::memset(out, 0, PackedMazeView::bytesPerRow(width));
+    for (int x = 0; x < width; ++x) {
+        out[x >> 2] |= static_cast<std::uint8_t>((cells[x] & 3) << ((x & 3) * 2));
+    }
+}
+
+bool MappedMaze::open(const std::string& path) {
+    // Walks touch cells in no particular order
+    if (!file.open(path, MappedFile::RANDOM)) {
+        return false;
+    }
+    if (file.size() < sizeof(PackedMazeHeader)) {
+        std::cerr << "Invalid header in maze file: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    const PackedMazeHeader& header = getHeader();
+    if (std::memcmp(header.magic, PackedMazeHeader::MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != PackedMazeHeader::VERSION || header.width == 0 || header.height == 0 ||
+        header.width > INT32_MAX || header.height > INT32_MAX) {
+        std::cerr << "Invalid header in maze file: " << path << std::endl;
+        close();
+        return false;
+    }
+    if (file.size() < sizeof(PackedMazeHeader) + PackedMazeView::bytesPerRow(header.width) * header.height) {
+        std::cerr << "Error reading maze data from file: " << path << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedMaze::close() {
+    file.close();
+}
+
+const PackedMazeHeader& MappedMaze::getHeader() const {
+    return *reinterpret_cast<const PackedMazeHeader*>(file.data());
+}
+
+PackedMazeView MappedMaze::getData() const {
+    const PackedMazeHeader& header = getHeader();
+    return PackedMazeView(reinterpret_cast<const std::uint8_t*>(file.data()) + sizeof(PackedMazeHeader),
+                          static_cast<int>(header.width), static_cast<int>(header.height));
+}
+
+bool MappedMaze::verifyChecksum() const {
+    PackedMazeView view = getData();
+    std::vector<std::uint8_t> row(view.getWidth());
+    std::uint64_t hash = hashDimensions(view.getWidth(), view.getHeight());
+    for (int y = 0; y < view.getHeight(); ++y) {
+        view.unpackRow(y, row.data());
+        hash = fnv1a(hash, row.data(), row.size());
+    }
+    return hash == getHeader().checksum;
+}
+
+BinaryRowSink::BinaryRowSink(const std::string& path, int startX, int startY, int exitX, int exitY, std::uint64_t seed)
+    : path(path), file(nullptr), header() {
+    std::memcpy(header.magic, PackedMazeHeader::MAGIC, sizeof(header.magic));
+    header.version = PackedMazeHeader::VERSION;
+    header.startX = startX;
+    header.startY = startY;
+    header.exitX = exitX;
+    header.exitY = exitY;
+    header.seed = seed;
+}
+
+BinaryRowSink::~BinaryRowSink() {
+    if (file) {
+        std::fclose(file);
+    }
+}
+
+bool BinaryRowSink::begin(int width, int height) {
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Unable to open file for writing: " << path << std::endl;
+        return false;
+    }
+    std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+
+    header.width = static_cast<std::uint32_t>(width);
+    header.height = static_cast<std::uint32_t>(height);
+    header.checksum = hashDimensions(width, height);
+    packed.assign(PackedMazeView::bytesPerRow(width), 0);
+
+    // The header is written again with the final checksum by end()
+    return std::fwrite(&header, sizeof(header), 1, file) == 1;
+}
+
+bool BinaryRowSink::writeRow(const std::uint8_t* cells) {
+    header.checksum = fnv1a(header.checksum, cells, header.width);
+    packRow(cells, static_cast<int>(header.width), packed.data());
+    return std::fwrite(packed.data(), 1, packed.size(), file) == packed.size();
+}
+
+bool BinaryRowSink::end() {
+    bool ok = std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = std::fclose(file) == 0 && ok;
+    file = nullptr;
+    if (!ok) {
+        std::cerr << "Error writing maze file: " << path << std::endl;
+    }
+    return ok;
+}
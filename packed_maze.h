@@ -0,0 +1,110 @@
+#ifndef PACKED_MAZE_H
+#define PACKED_MAZE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "maze.h"
+#include "maze_stream.h"
+#include "mapped_file.h"
+#include "walk.h"
+
+// Binary maze format: a fixed header followed by the cells at 2 bits each, row by row, with
+// every row padded to whole bytes. Cell x of a row sits in byte x / 4 at bit 2 * (x % 4).
+// Fields are stored in the host byte order, which is little-endian on every target we build.
+struct PackedMazeHeader {
+    static constexpr char MAGIC[4] = { 'R', 'M', 'Z', 'B' };
+    static constexpr std::uint32_t VERSION = 1;
+
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::int32_t startX, startY;  // -1 when unknown
+    std::int32_t exitX, exitY;    // -1 when unknown
+    std::uint64_t seed;           // 0 when unknown
+    std::uint64_t checksum;       // Content hash of the cells (see maze_stream.h)
+};
+
+static_assert(sizeof(PackedMazeHeader) == 48, "The packed maze header must have no padding");
+
+// Read-only view over 2-bit packed cells, queried the same way as a MazeView
+class PackedMazeView {
+public:
+    PackedMazeView(const std::uint8_t* cells, int width, int height)
+        : cells(cells), width(width), height(height), rowBytes(bytesPerRow(width)) { }
+
+    static size_t bytesPerRow(int width) { return (static_cast<size_t>(width) + 3) / 4; }
+
+    // Cell type at (x, y); everything outside the maze is a wall
+    std::uint8_t operator()(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width || y >= height) {
+            return Maze::WALL;
+        }
+        return (cells[y * rowBytes + (x >> 2)] >> ((x & 3) * 2)) & 3;
+    }
+
+    // Open-neighbour mask at (x, y) (see walk.h for the direction order)
+    std::uint8_t openMask(int x, int y) const {
+        int mask = 0;
+        for (int dir = 0; dir < 4; ++dir) {
+            if ((*this)(x + DIRECTION_DX[dir], y + DIRECTION_DY[dir]) != Maze::WALL) {
+                mask |= 1 << dir;
+            }
+        }
+        return static_cast<std::uint8_t>(mask);
+    }
+
+    // Expand row y to one cell type per byte
+    void unpackRow(int y, std::uint8_t* out) const;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    const std::uint8_t* getCells() const { return cells; }
+
+private:
+    const std::uint8_t* cells;
+    int width;
+    int height;
+    size_t rowBytes;
+};
+
+// Pack one row of cell types, one per byte, into 2-bit cells
+void packRow(const std::uint8_t* cells, int width, std::uint8_t* out);
+
+// Packed maze file mapped read-only into memory, so its cells are used in place
+class MappedMaze {
+public:
+    // Map the file and check its header; reports problems on std::cerr
+    bool open(const std::string& path);
+    void close();
+
+    const PackedMazeHeader& getHeader() const;
+    PackedMazeView getData() const;
+
+    // Recompute the content hash of the cells and compare it with the header
+    bool verifyChecksum() const;
+
+private:
+    MappedFile file;
+};
+
+// Writes rows as a packed maze file; the checksum is filled in once the last row is written
+class BinaryRowSink : public MazeRowSink {
+public:
+    BinaryRowSink(const std::string& path, int startX, int startY, int exitX, int exitY, std::uint64_t seed);
+    ~BinaryRowSink() override;
+
+    bool begin(int width, int height) override;
+    bool writeRow(const std::uint8_t* cells) override;
+    bool end() override;
+
+private:
+    std::string path;
+    std::FILE* file;
+    PackedMazeHeader header;
+    std::vector<std::uint8_t> packed;  // One packed row
+};
+
+#endif // PACKED_MAZE_H
@@ -1,28 +1,65 @@
 #include "particle.h"
 #include "maze.h"
-#include <cstdlib>  // For rand()
 #include <iostream>
 
-Particle::Particle(int startX, int startY) : x(startX), y(startY) {
-    visitedCells.push_back({x, y}); // Add the starting position to the visited cells
+Particle::Particle(int startX, int startY, const RandomStream& stream)
+    : x(startX), y(startY), stream(stream), bits(0), draws(0), visitedCells(startX, startY) { }
+
+int Particle::nextDraw() {
+    if (draws == 0) {
+        bits = stream.next();
+        draws = 16;
+    }
+    int draw = bits & 3;
+    bits >>= 2;
+    --draws;
+    return draw;
 }
 
-void Particle::move(const std::vector<std::vector<int>>& maze) {
-    const int directions[4][2] = { {0, 1}, {0, -1}, {1, 0}, {-1, 0} };
-    int dir = rand() % 4;
-    int nx = x + directions[dir][0];
-    int ny = y + directions[dir][1];
+template <typename Grid>
+void Particle::step(const Grid& maze, WalkMode mode) {
+    int dir;
+    if (mode == WalkMode::LAZY) {
+        dir = nextDraw();
+    } else {
+        // Choose among the open neighbours only
+        const auto& moves = MOVE_TABLE[maze.openMask(x, y)];
+        do {
+            dir = moves[nextDraw()];
+        } while (dir == REDRAW);
+        if (dir == STAY) {
+            return;
+        }
+    }
+    int nx = x + DIRECTION_DX[dir];
+    int ny = y + DIRECTION_DY[dir];
 
   //  std::cout << "Trying to move particle from (" << x << ", " << y << ") to (" << nx << ", " << ny << ")\n";
 
-    // Check if the new position is within bounds and not a wall
-    if (nx >= 0 && ny >= 0 && nx < maze[0].size() && ny < maze.size() && maze[ny][nx] != Maze::WALL) {
+    // Cells outside the grid read as walls, which keeps the particle in bounds
+    if (maze(nx, ny) != Maze::WALL) {
         x = nx;
         y = ny;
-        visitedCells.push_back({x, y}); // Add the new position to the visited cells
+        visitedCells.push(dir); // Add the new position to the visited cells
     }
 }
 
+void Particle::move(const MazeView& maze, WalkMode mode) {
+    step(maze, mode);
+}
+
+void Particle::move(const ImplicitMaze& maze, WalkMode mode) {
+    step(maze, mode);
+}
+
+void Particle::move(const PackedMazeView& maze, WalkMode mode) {
+    step(maze, mode);
+}
+
+void Particle::move(const TiledMazeStore& maze, WalkMode mode) {
+    step(maze, mode);
+}
+
 int Particle::getX() const {
     return x;
 }
@@ -31,6 +68,6 @@ int Particle::getY() const {
     return y;
 }
 
-const std::vector<std::pair<int, int>>& Particle::getVisitedCells() const {
+const Trajectory& Particle::getVisitedCells() const {
     return visitedCells;
 }
@@ -2,21 +2,41 @@
 #define PARTICLE_H
 
 #include <vector>
-#include <utility> // for std::pair
+#include "maze.h"
+#include "implicit_maze.h"
+#include "packed_maze.h"
+#include "tiled_maze.h"
+#include "rng.h"
+#include "walk.h"
+#include "trajectory.h"
 
 class Particle {
 public:
-    Particle(int startX, int startY);
+    Particle(int startX, int startY, const RandomStream& stream = RandomStream());
 
-    void move(const std::vector<std::vector<int>>& maze);
+    // Grids are queried only through their cell types and open masks, so a particle walks
+    // stored, implicit, memory-mapped and tiled on-disk mazes the same way
+    void move(const MazeView& maze, WalkMode mode = WalkMode::LAZY);
+    void move(const ImplicitMaze& maze, WalkMode mode = WalkMode::LAZY);
+    void move(const PackedMazeView& maze, WalkMode mode = WalkMode::LAZY);
+    void move(const TiledMazeStore& maze, WalkMode mode = WalkMode::LAZY);
 
     int getX() const;
     int getY() const;
-    const std::vector<std::pair<int, int>>& getVisitedCells() const;
+    const Trajectory& getVisitedCells() const;
 
 private:
+    template <typename Grid>
+    void step(const Grid& maze, WalkMode mode);
+
+    // Next two-bit draw from the particle's random stream
+    int nextDraw();
+
     int x, y; // Current position of the particle
-    std::vector<std::pair<int, int>> visitedCells; // Stores all visited cells by the particle
+    RandomStream stream;   // Source of the particle's moves
+    std::uint32_t bits;    // Buffered random bits
+    int draws;             // Two-bit draws left in bits
+    Trajectory visitedCells; // Stores all visited cells by the particle
 };
 
 #endif // PARTICLE_H
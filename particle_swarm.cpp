@@ -0,0 +1,254 @@
+#include "particle_swarm.h"
+#include "particle.h"
+#include <algorithm>
+#include <utility>
+
+ParticleSwarm::ParticleSwarm(const MazeView& maze, int count, int startX, int startY, RecordingPolicy recording,
+                             RandomStream::Kind kind, std::uint64_t seed, WalkMode mode)
+    : maze(maze),
+      mode(mode),
+      deltas{ maze.getStride(), -maze.getStride(), 1, -1 },
+      positions(count, maze.index(startX, startY)),
+      bits(count, 0),
+      draws(count, 0),
+      kind(kind),
+      seed(seed),
+      startX(startX),
+      startY(startY),
+      recording(recording),
+      simd(detectSimdLevel()) {
+    streams.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        streams.emplace_back(kind, seed, static_cast<std::uint32_t>(i));
+    }
+    if (recording == RecordingPolicy::FULL) {
+        paths.assign(count, Trajectory(startX, startY));
+    }
+    if (recording == RecordingPolicy::VISITS) {
+        // Every particle starts with a visit to the start cell
+        visits.emplace_back(maze);
+        visits[0].data()[maze.index(startX, startY)] = static_cast<std::uint64_t>(count);
+    }
+    if (recording == RecordingPolicy::FULL || recording == RecordingPolicy::VISITS) {
+        savedPositions = positions;
+        savedBits = bits;
+        savedDraws = draws;
+        savedStreams = streams;
+        stepsTaken.assign(count, 0);
+    }
+}
+
+inline int ParticleSwarm::nextDraw(int particle) {
+    if (draws[particle] == 0) {
+        bits[particle] = streams[particle].next();
+        draws[particle] = 16;
+    }
+    int draw = bits[particle] & 3;
+    bits[particle] >>= 2;
+    --draws[particle];
+    return draw;
+}
+
+inline bool ParticleSwarm::stepParticle(int particle, const std::uint8_t* cells, bool record, std::uint64_t* visits) {
+    int position = positions[particle];
+    int dir;
+    if (mode == WalkMode::LAZY) {
+        dir = nextDraw(particle);
+    } else {
+        // Choose among the open neighbours only
+        const auto& moves = MOVE_TABLE[cells[position] >> MazeView::OPEN_SHIFT];
+        do {
+            dir = moves[nextDraw(particle)];
+        } while (dir == REDRAW);
+        if (dir == STAY) {
+            return false;
+        }
+    }
+
+    int next = position + deltas[dir];
+    std::uint8_t cell = cells[next] & MazeView::TYPE_BITS;
+
+    // The wall border around the grid keeps every particle in bounds
+    if (cell == Maze::WALL) {
+        return false;
+    }
+    positions[particle] = next;
+    if (record) {
+        paths[particle].push(dir);
+    }
+    if (visits) {
+        ++visits[next];
+    }
+    return cell == Maze::EXIT;
+}
+
+ExitEvent ParticleSwarm::advance(int first, int last, std::uint64_t firstStep, int steps, int shard) {
+    const std::uint8_t* cells = maze.getCells();
+    const bool record = recording == RecordingPolicy::FULL;
+    std::uint64_t* counts = recording == RecordingPolicy::VISITS ? visits[shard].data() : nullptr;
+    ExitEvent event;
+    int i = first;
+
+    // Whole vectors go through the SIMD kernel, the remainder through the scalar one
+    if (!record && !counts && simd != SimdLevel::SCALAR) {
+        int width = simdWidth(simd);
+        int count = (last - first) / width * width;
+        SwarmLanes lanes = { positions.data(), bits.data(), draws.data(), streams.data() };
+        int arrivalStep = 0;
+        int winner = stepLanes(simd, cells, maze.getStride(), mode, lanes, first, count, steps, arrivalStep);
+        if (winner >= 0) {
+            event = { firstStep + arrivalStep, winner };
+            steps = arrivalStep;
+        }
+        i += count;
+    }
+
+    // Recorded walks may have to be rewound to the winner's step
+    const bool checkpoint = record || counts;
+    if (checkpoint) {
+        for (int p = first; p < last; ++p) {
+            savedPositions[p] = positions[p];
+            savedBits[p] = bits[p];
+            savedDraws[p] = draws[p];
+            savedStreams[p] = streams[p];
+        }
+    }
+
+    for (; i < last; ++i) {
+        int taken = steps;
+        for (int step = 0; step < steps; ++step) {
+            if (stepParticle(i, cells, record, counts)) {
+                // Later particles only matter if they arrive strictly earlier
+                event = { firstStep + step, i };
+                taken = step + 1;
+                steps = step;
+                break;
+            }
+        }
+        if (checkpoint) {
+            stepsTaken[i] = taken;
+        }
+    }
+    return event;
+}
+
+void ParticleSwarm::rewind(int first, int last, const ExitEvent& winner, std::uint64_t epochStart, int shard) {
+    const bool record = recording == RecordingPolicy::FULL;
+    std::uint64_t* counts = recording == RecordingPolicy::VISITS ? visits[shard].data() : nullptr;
+    if (!record && !counts) {
+        return;
+    }
+    const std::uint8_t* cells = maze.getCells();
+
+    for (int i = first; i < last; ++i) {
+        int limit = static_cast<int>(winner.step - epochStart) + (i <= winner.particle ? 1 : 0);
+        int taken = stepsTaken[i];
+        if (taken <= limit) {
+            continue;
+        }
+
+        // Replay the epoch up to the limit, which is where the particle should have stopped
+        positions[i] = savedPositions[i];
+        bits[i] = savedBits[i];
+        draws[i] = savedDraws[i];
+        streams[i] = savedStreams[i];
+        for (int step = 0; step < limit; ++step) {
+            stepParticle(i, cells, false, nullptr);
+        }
+        int position = positions[i];
+        std::uint32_t particleBits = bits[i];
+        std::uint8_t particleDraws = draws[i];
+        RandomStream stream = streams[i];
+
+        // Replay the extra steps to find the moves to take back; counts are 64-bit sums over
+        // all shards, so one shard may go below zero and wrap
+        std::size_t moves = 0;
+        for (int step = limit; step < taken; ++step) {
+            int before = positions[i];
+            stepParticle(i, cells, false, nullptr);
+            if (positions[i] != before) {
+                ++moves;
+                if (counts) {
+                    --counts[positions[i]];
+                }
+            }
+        }
+        if (record) {
+            paths[i].truncate(paths[i].size() - moves);
+        }
+
+        positions[i] = position;
+        bits[i] = particleBits;
+        draws[i] = particleDraws;
+        streams[i] = stream;
+        stepsTaken[i] = limit;
+    }
+}
+
+void ParticleSwarm::setVisitShards(int count) {
+    if (recording == RecordingPolicy::VISITS && static_cast<int>(visits.size()) < count) {
+        visits.resize(count, VisitCounts(maze));
+    }
+}
+
+SimdLevel ParticleSwarm::getSimdLevel() const {
+    return simd;
+}
+
+void ParticleSwarm::setSimdLevel(SimdLevel level) {
+    simd = level;
+}
+
+int ParticleSwarm::size() const {
+    return static_cast<int>(positions.size());
+}
+
+int ParticleSwarm::getX(int particle) const {
+    return maze.xOf(positions[particle]);
+}
+
+int ParticleSwarm::getY(int particle) const {
+    return maze.yOf(positions[particle]);
+}
+
+Trajectory ParticleSwarm::getExitPath(int particle) const {
+    switch (recording) {
+        case RecordingPolicy::FULL:
+            return paths[particle];
+        case RecordingPolicy::EXIT_PATH:
+        case RecordingPolicy::VISITS: {
+            // The walk depends only on the particle's stream, so it can be replayed exactly
+            Particle replay(startX, startY, RandomStream(kind, seed, static_cast<std::uint32_t>(particle)));
+            while (maze(replay.getX(), replay.getY()) != Maze::EXIT) {
+                replay.move(maze, mode);
+            }
+            return replay.getVisitedCells();
+        }
+        default:
+            return Trajectory();
+    }
+}
+
+std::vector<Trajectory> ParticleSwarm::takePaths() {
+    return std::move(paths);
+}
+
+VisitCounts ParticleSwarm::takeVisits() {
+    if (visits.empty()) {
+        return VisitCounts();
+    }
+
+    // Sum the shards into the first one
+    VisitCounts total = std::move(visits[0]);
+    std::uint64_t* sum = total.data();
+    const long long cells = static_cast<long long>(total.cellCount());
+    for (std::size_t s = 1; s < visits.size(); ++s) {
+        const std::uint64_t* shard = visits[s].data();
+#pragma omp parallel for schedule(static)
+        for (long long i = 0; i < cells; ++i) {
+            sum[i] += shard[i];
+        }
+    }
+    visits.clear();
+    return total;
+}
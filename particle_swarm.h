@@ -0,0 +1,112 @@
+#ifndef PARTICLE_SWARM_H
+#define PARTICLE_SWARM_H
+
+#include <cstdint>
+#include <vector>
+#include "maze.h"
+#include "rng.h"
+#include "walk.h"
+#include "trajectory.h"
+#include "swarm_simd.h"
+#include "visit_counts.h"
+
+// What a swarm keeps of the particles' walks
+enum class RecordingPolicy {
+    NONE,       // Nothing; only the walk itself is simulated
+    EXIT_PATH,  // Nothing while simulating; the winner's walk is replayed from its stream afterwards
+    FULL,       // Every particle's trajectory, handed over with takePaths()
+    VISITS      // How often each cell was entered, handed over with takeVisits(); the winner's
+                // walk is replayed like EXIT_PATH
+};
+
+// Arrival of a particle at the exit. Events order the way a sequential simulation that
+// moves every particle once per round would find them: by step, then by particle index.
+struct ExitEvent {
+    static constexpr std::uint64_t NO_STEP = UINT64_MAX;
+
+    std::uint64_t step = NO_STEP;  // Zero-based step on which the particle arrived
+    int particle = -1;
+
+    bool found() const { return particle >= 0; }
+    bool operator<(const ExitEvent& other) const {
+        return step != other.step ? step < other.step : particle < other.particle;
+    }
+};
+
+// Structure-of-arrays simulation of many particles walking the same maze.
+// Positions are kept as linear indices into the padded maze grid, so a step is
+// a table lookup, one load and one compare per particle.
+class ParticleSwarm {
+public:
+    // Particle i draws its moves from RandomStream(kind, seed, i), so every walk is
+    // reproducible for a given seed no matter which thread advances it
+    ParticleSwarm(const MazeView& maze, int count, int startX, int startY, RecordingPolicy recording,
+                  RandomStream::Kind kind = RandomStream::PHILOX, std::uint64_t seed = 0,
+                  WalkMode mode = WalkMode::LAZY);
+
+    // Advance particles [first, last) by up to `steps` steps each, numbering them from firstStep.
+    // Returns the earliest arrival in the range; once one is found, later particles are only
+    // advanced far enough to tell whether they arrive earlier, so the range falls out of lockstep.
+    // Visits are counted into the given shard; threads advancing at the same time need different ones.
+    ExitEvent advance(int first, int last, std::uint64_t firstStep, int steps, int shard = 0);
+
+    // Undo the moves that particles [first, last) made past the point where a sequential
+    // simulation stops once `winner` has arrived: particles up to the winner end on its step,
+    // later ones on the step before. advance() may walk a block past that point before the
+    // winner is known; this replays the last epoch from a checkpoint and trims the recorded
+    // trajectories and visit counts, so they do not depend on the threads. epochStart is the
+    // first step of the epoch the winner arrived in. Only FULL and VISITS need it.
+    void rewind(int first, int last, const ExitEvent& winner, std::uint64_t epochStart, int shard = 0);
+
+    // Number of visit count shards, one per thread that may call advance() (VISITS only)
+    void setVisitShards(int count);
+
+    // Kernel used when trajectories are not recorded; defaults to the best the CPU supports
+    SimdLevel getSimdLevel() const;
+    void setSimdLevel(SimdLevel level);
+
+    int size() const;
+    int getX(int particle) const;
+    int getY(int particle) const;
+
+    // Walk of a particle that has reached the exit; empty when the policy is NONE
+    Trajectory getExitPath(int particle) const;
+
+    // Hand over the trajectories of all particles (empty unless the policy is FULL)
+    std::vector<Trajectory> takePaths();
+
+    // Hand over the visit counts summed over all shards (empty unless the policy is VISITS)
+    VisitCounts takeVisits();
+
+private:
+    // Next two-bit draw from a particle's random stream
+    int nextDraw(int particle);
+
+    // Advance one particle with the scalar kernel; returns true if it reached the exit.
+    // Moves are appended to its trajectory if record is set and counted in visits if it is not null.
+    bool stepParticle(int particle, const std::uint8_t* cells, bool record, std::uint64_t* visits);
+
+    MazeView maze;
+    WalkMode mode;
+    int deltas[4];              // Linear index offsets for down, up, right, left
+    std::vector<int> positions; // Linear index of each particle
+    std::vector<std::uint32_t> bits;   // Buffered random bits of each particle
+    std::vector<std::uint8_t> draws;   // Two-bit draws left in bits
+    std::vector<RandomStream> streams;
+    RandomStream::Kind kind;
+    std::uint64_t seed;
+    int startX, startY;
+    RecordingPolicy recording;
+    SimdLevel simd;
+    std::vector<Trajectory> paths;
+    std::vector<VisitCounts> visits;  // Per-thread shards, summed by takeVisits()
+
+    // State at the start of the last advance() and the steps it took, for rewind()
+    std::vector<int> savedPositions;
+    std::vector<std::uint32_t> savedBits;
+    std::vector<std::uint8_t> savedDraws;
+    std::vector<RandomStream> savedStreams;
+    std::vector<int> stepsTaken;
+};
+
+#endif // PARTICLE_SWARM_H
@@ -1,11 +1,14 @@
 #include "maze.h"
-#include "particle.h"
+#include "particle_swarm.h"
+#include "lockstep_scheduler.h"
+#include "render_queue.h"
 #include <iostream>
 #include <vector>
 #include <filesystem>
 #include <string>
 #include <chrono>
 #include <iomanip>
+#include <memory>
 #include <omp.h>  // Include OpenMP header
 #include <fstream> // Include fstream for CSV file operations
 
@@ -22,12 +25,25 @@ int main() {
     std::vector<std::string> mazeFiles = {"maze_50.txt"};
     std::vector<int> particleCounts = {50, 100};
     std::vector<int> threadCounts = {2,4,6,8,10,12};  // Array of thread counts
+    const std::uint64_t seed = 12345;                        // Same seed, same walks
+    const RandomStream::Kind rngKind = RandomStream::PHILOX;  // Per-particle generator
+    const WalkMode walkMode = WalkMode::LAZY;                 // LEGAL skips moves into walls
+    const RecordingPolicy recording = RecordingPolicy::EXIT_PATH;  // FULL keeps every walk, VISITS a heatmap
+    const int quantum = 256;                                   // Steps per particle per epoch
+    const int renderWorkers = 2;                               // Images encoded at once in the background
+    const int renderBacklog = 4;                               // Images waiting before the sweep blocks
+    const bool isolateTimings = false;                         // true drains the render queue before each timed run
+
+    // Images are rendered and written in the background while the sweep goes on. Encoding then
+    // shares the cores with the timed runs; isolateTimings waits for it first, for benchmarking.
+    RenderQueue renderQueue(renderWorkers, renderBacklog);
+    auto sweepStart = std::chrono::high_resolution_clock::now();
 
     // Open CSV file for writing results
     std::ofstream csvFile("../output/simulation_times.csv");
 
     // Write headers to CSV file
-    csvFile << "Dataset,Particles,Threads,Time (seconds)\n";
+    csvFile << "Dataset,Particles,Threads,Time (seconds),Stop latency (seconds)\n";
 
     for (const auto& mazeFilename : mazeFiles) {
         Maze maze;
@@ -38,77 +54,79 @@ int main() {
             continue;
         }
 
+        // Immutable copy shared by the render jobs of this maze
+        auto mazeSnapshot = std::make_shared<const Maze>(maze);
+
         for (int numParticles : particleCounts) {
             for (int numThreads : threadCounts) {  // Loop through different thread counts
                 DEBUG_MSG("Simulating " << numParticles << " particles with " << numThreads << " threads...");
 
-                std::vector<std::vector<std::pair<int, int>>> particlePaths(numParticles);
-                std::vector<std::pair<int, int>> exitPath;
-                bool foundExit = false;
-                int particleThatFoundExit = -1;
+                ParticleSwarm swarm(maze.getData(), numParticles, 1, 1, recording, rngKind, seed, walkMode);
+                DEBUG_MSG("Step kernel: " << simdLevelName(swarm.getSimdLevel()));
+                Trajectory exitPath;
+                LockstepScheduler scheduler(quantum, numThreads);
 
                 // Set the number of threads for this simulation
                 omp_set_num_threads(numThreads);
+                DEBUG_MSG("Starting parallel simulation with " << numThreads << " threads.");
+
+                if (isolateTimings) {
+                    renderQueue.wait();
+                }
+                bool rendering = renderQueue.busy();
 
                 // Start timing
                 auto startTime = std::chrono::high_resolution_clock::now();
 
-#pragma omp parallel
-                {
-                    // Each thread will simulate particles
-#pragma omp single
-                    {
-                        DEBUG_MSG("Starting parallel simulation with " << omp_get_num_threads() << " threads.");
-                    }
-
-#pragma omp for schedule(dynamic)
-                    for (int i = 0; i < numParticles; ++i) {
-                        Particle particle(1, 1);
-                        std::vector<std::pair<int, int>> path;
-
-                        while (!foundExit) {
-                            particle.move(maze.getData());
-                            path = particle.getVisitedCells();
-
-                            // Check for exit and update shared variables if needed
-                            if (maze.getData()[particle.getY()][particle.getX()] == Maze::EXIT) {
-#pragma omp critical
-                                {
-                                    if (!foundExit) {
-                                        foundExit = true;
-                                        particleThatFoundExit = i;
-                                        exitPath = path;
-                                    }
-                                }
-                                break; // Exit the while loop
-                            }
-                        }
-                        particlePaths[i] = path; // Save the path for this particle
-                    }
-                }
+                // Every epoch advances all particles, partitioned across the threads
+                ExitEvent exit = scheduler.run(swarm);
 
                 // End timing
                 auto endTime = std::chrono::high_resolution_clock::now();
                 std::chrono::duration<double> elapsed = endTime - startTime;
+                std::chrono::duration<double> stopLatency{scheduler.getStopLatency()};
+
+                if (exit.found()) {
+                    DEBUG_MSG("Particle " << exit.particle << " found the exit on step " << exit.step + 1);
+                    exitPath = swarm.getExitPath(exit.particle);
+                }
 
                 std::cout << "Simulation finished for " << numParticles << " particles with " << numThreads << " threads." << std::endl;
                 std::cout << "Time taken: " << std::fixed << std::setprecision(4) << elapsed.count() << " seconds" << std::endl;
+                if (rendering) {
+                    std::cout << "(Earlier images were encoding in the background during this run)" << std::endl;
+                }
+                std::cout << "Exit found to all threads stopped: " << std::fixed << std::setprecision(6) << stopLatency.count() << " seconds" << std::endl;
 
-                // Save the maze with all particle paths
+                // Save the maze with all particle paths, or the visit heatmap, in the background
                 std::string imageFilename = "../output/parallel_" + mazeFilename.substr(0, mazeFilename.find_last_of('.')) +
                                             "_after_particles_" + std::to_string(numParticles) +
                                             "_threads_" + std::to_string(numThreads) + ".png";
-                maze.saveAsImage(imageFilename, particlePaths, exitPath, true);
+                if (recording == RecordingPolicy::VISITS) {
+                    renderQueue.submit([mazeSnapshot, imageFilename, visits = swarm.takeVisits(), exitPath = std::move(exitPath)] {
+                        mazeSnapshot->saveAsHeatmap(imageFilename, visits, exitPath);
+                    });
+                } else {
+                    renderQueue.submit([mazeSnapshot, imageFilename, paths = swarm.takePaths(), exitPath = std::move(exitPath)] {
+                        mazeSnapshot->saveAsImage(imageFilename, paths, exitPath, true);
+                    });
+                }
 
                 // Write results to CSV
                 csvFile << mazeFilename.substr(mazeFilename.find_last_of('/') + 1) << ","
                         << numParticles << ","
                         << numThreads << ","
-                        << std::fixed << std::setprecision(4) << elapsed.count() << "\n";
+                        << std::fixed << std::setprecision(4) << elapsed.count() << ","
+                        << std::fixed << std::setprecision(6) << stopLatency.count() << "\n";
             }
         }
     }
 
+    // The sweep is done once the last image is written
+    renderQueue.wait();
+    std::chrono::duration<double> sweepTime = std::chrono::high_resolution_clock::now() - sweepStart;
+    std::cout << "Sweep finished in " << std::fixed << std::setprecision(4) << sweepTime.count() << " seconds" << std::endl;
+
     // Close CSV file
     csvFile.close();
 
@@ -1,11 +1,14 @@
 #include "maze.h"
-#include "particle.h"
+#include "particle_swarm.h"
+#include "lockstep_scheduler.h"
+#include "render_queue.h"
 #include <iostream>
 #include <vector>
 #include <filesystem>
 #include <string>
 #include <chrono>
 #include <iomanip>
+#include <memory>
 
 namespace fs = std::filesystem;
 
@@ -21,6 +24,19 @@ int main() {
     //std::vector<std::string> mazeFiles = {"maze_50.txt", "maze_100.txt"}; // datasets
     std::vector<std::string> mazeFiles = {"maze_50.txt"}; // datasets
     std::vector<int> particleCounts = {50,100};  // parameter
+    const std::uint64_t seed = 12345;                        // Same seed, same walks
+    const RandomStream::Kind rngKind = RandomStream::PHILOX;  // Per-particle generator
+    const WalkMode walkMode = WalkMode::LAZY;                 // LEGAL skips moves into walls
+    const RecordingPolicy recording = RecordingPolicy::EXIT_PATH;  // FULL keeps every walk, VISITS a heatmap
+    const int quantum = 256;                                   // Steps per particle per epoch
+    const int renderWorkers = 2;                               // Images encoded at once in the background
+    const int renderBacklog = 4;                               // Images waiting before the sweep blocks
+    const bool isolateTimings = false;                         // true drains the render queue before each timed run
+
+    // Images are rendered and written in the background while the sweep goes on. Encoding then
+    // shares the cores with the timed runs; isolateTimings waits for it first, for benchmarking.
+    RenderQueue renderQueue(renderWorkers, renderBacklog);
+    auto sweepStart = std::chrono::high_resolution_clock::now();
 
     for (const auto& mazeFilename : mazeFiles) {
         Maze maze;
@@ -32,52 +48,62 @@ int main() {
             continue; // Skip to the next maze file
         }
 
+        // Immutable copy shared by the render jobs of this maze
+        auto mazeSnapshot = std::make_shared<const Maze>(maze);
+
         // Iterate over different numbers of particles
         for (int numParticles : particleCounts) {
             DEBUG_MSG("Simulating " << numParticles << " particles...");
 
-            std::vector<Particle> particles(numParticles, Particle(startX, startY));
-            std::vector<std::vector<std::pair<int, int>>> particlePaths(numParticles);
-            std::vector<std::pair<int, int>> exitPath;
+            ParticleSwarm swarm(maze.getData(), numParticles, startX, startY, recording, rngKind, seed, walkMode);
+            DEBUG_MSG("Step kernel: " << simdLevelName(swarm.getSimdLevel()));
+            Trajectory exitPath;
+
+            LockstepScheduler scheduler(quantum, 1);
 
-            bool foundExit = false;
-            int particleThatFoundExit = -1;
+            if (isolateTimings) {
+                renderQueue.wait();
+            }
+            bool rendering = renderQueue.busy();
 
             // Start timing
             auto startTime = std::chrono::high_resolution_clock::now();
 
-            // Simulate all particles
-            while (!foundExit) {
-                for (int i = 0; i < numParticles; ++i) {
-                    auto& particle = particles[i];
-
-                    particle.move(maze.getData());
-                    particlePaths[i] = particle.getVisitedCells();
-
-                    if (maze.getData()[particle.getY()][particle.getX()] == Maze::EXIT) {
-                        DEBUG_MSG("Particle " << i << " found the exit at (" << particle.getX() << ", " << particle.getY() << ")");
-                        foundExit = true;
-                        particleThatFoundExit = i;
-                        break; // particle has found exit
-                    }
-                }
-            }
+            // Simulate all particles in lockstep until one reaches the exit
+            ExitEvent exit = scheduler.run(swarm);
 
             // End timing
             auto endTime = std::chrono::high_resolution_clock::now();
             std::chrono::duration<double> elapsed = endTime - startTime;
 
-            if (foundExit) {
-                exitPath = particles[particleThatFoundExit].getVisitedCells();
+            if (exit.found()) {
+                DEBUG_MSG("Particle " << exit.particle << " found the exit at (" << swarm.getX(exit.particle) << ", " << swarm.getY(exit.particle) << ") on step " << exit.step + 1);
+                exitPath = swarm.getExitPath(exit.particle);
             }
             std::cout << "Simulation finished for " << numParticles << " particles." << std::endl;
             std::cout << "Time taken: " << std::fixed << std::setprecision(4) << elapsed.count() << " seconds" << std::endl;
+            if (rendering) {
+                std::cout << "(Earlier images were encoding in the background during this run)" << std::endl;
+            }
 
-            // Save the maze with all particle paths
+            // Save the maze with all particle paths, or the visit heatmap, in the background
             std::string imageFilename = "../output/sequential_"+mazeFilename.substr(0, mazeFilename.find_last_of('.')) + "_after_particles_" + std::to_string(numParticles) + ".png";
-            maze.saveAsImage(imageFilename, particlePaths, exitPath, true);
+            if (recording == RecordingPolicy::VISITS) {
+                renderQueue.submit([mazeSnapshot, imageFilename, visits = swarm.takeVisits(), exitPath = std::move(exitPath)] {
+                    mazeSnapshot->saveAsHeatmap(imageFilename, visits, exitPath);
+                });
+            } else {
+                renderQueue.submit([mazeSnapshot, imageFilename, paths = swarm.takePaths(), exitPath = std::move(exitPath)] {
+                    mazeSnapshot->saveAsImage(imageFilename, paths, exitPath, true);
+                });
+            }
         }
     }
 
+    // The sweep is done once the last image is written
+    renderQueue.wait();
+    std::chrono::duration<double> sweepTime = std::chrono::high_resolution_clock::now() - sweepStart;
+    std::cout << "Sweep finished in " << std::fixed << std::setprecision(4) << sweepTime.count() << " seconds" << std::endl;
+
     return 0;
 }
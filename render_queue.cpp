@@ -0,0 +1,71 @@
+#include "render_queue.h"
+#include <algorithm>
+#include <utility>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+RenderQueue::RenderQueue(int workers, int capacity)
+    : capacity(static_cast<std::size_t>(std::max(1, capacity))), running(0), stopping(false) {
+    for (int i = 0; i < std::max(1, workers); ++i) {
+        threads.emplace_back(&RenderQueue::work, this);
+    }
+}
+
+RenderQueue::~RenderQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void RenderQueue::submit(std::function<void()> job) {
+    std::unique_lock<std::mutex> lock(mutex);
+    spaceAvailable.wait(lock, [this] { return jobs.size() < capacity; });
+    jobs.push_back(std::move(job));
+    lock.unlock();
+    jobAvailable.notify_one();
+}
+
+void RenderQueue::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return jobs.empty() && running == 0; });
+}
+
+bool RenderQueue::busy() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !jobs.empty() || running > 0;
+}
+
+void RenderQueue::work() {
+#ifdef _OPENMP
+    // Keep the renderers' parallel loops off the cores the simulation is using
+    omp_set_num_threads(1);
+#endif
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        // Queued jobs are still run after shutdown is requested
+        jobAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (jobs.empty()) {
+            return;
+        }
+        std::function<void()> job = std::move(jobs.front());
+        jobs.pop_front();
+        ++running;
+        lock.unlock();
+        spaceAvailable.notify_one();
+
+        job();
+
+        lock.lock();
+        --running;
+        if (jobs.empty() && running == 0) {
+            idle.notify_all();
+        }
+    }
+}
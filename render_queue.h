@@ -0,0 +1,50 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Background stage that renders and encodes images while the caller goes on simulating.
+// Jobs must own everything they draw (a snapshot of the maze, the paths or visit counts),
+// since the caller moves on as soon as a job is submitted. At most `capacity` jobs wait at
+// once, so submitting blocks rather than piling up snapshots when encoding falls behind.
+// Each worker runs its OpenMP regions on one thread, so the pool takes `workers` cores at most.
+class RenderQueue {
+public:
+    RenderQueue(int workers = 2, int capacity = 4);
+
+    // Waits for every submitted job to finish
+    ~RenderQueue();
+
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    // Queue a job; blocks while `capacity` jobs are waiting
+    void submit(std::function<void()> job);
+
+    // Block until every submitted job has finished
+    void wait();
+
+    // Whether any submitted job has not finished yet
+    bool busy();
+
+private:
+    void work();
+
+    std::size_t capacity;
+    std::vector<std::thread> threads;
+    std::deque<std::function<void()>> jobs;
+    std::size_t running;                     // Jobs taken by a worker and not finished yet
+    bool stopping;
+    std::mutex mutex;
+    std::condition_variable jobAvailable;    // Workers wait for jobs or shutdown
+    std::condition_variable spaceAvailable;  // Submitters wait for room in the queue
+    std::condition_variable idle;            // wait() waits for an empty queue and idle workers
+};
+
+#endif // RENDER_QUEUE_H
@@ -0,0 +1,63 @@
+#include "rng.h"
+
+namespace {
+
+inline std::uint64_t rotl(std::uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+} // namespace
+
+std::array<std::uint32_t, 4> philox4x32(std::array<std::uint32_t, 4> counter, std::array<std::uint32_t, 2> key) {
+    const std::uint32_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+    const std::uint32_t W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+
+    for (int round = 0; round < 10; ++round) {
+        std::uint64_t p0 = static_cast<std::uint64_t>(M0) * counter[0];
+        std::uint64_t p1 = static_cast<std::uint64_t>(M1) * counter[2];
+        counter = { static_cast<std::uint32_t>(p1 >> 32) ^ counter[1] ^ key[0],
+                    static_cast<std::uint32_t>(p1),
+                    static_cast<std::uint32_t>(p0 >> 32) ^ counter[3] ^ key[1],
+                    static_cast<std::uint32_t>(p0) };
+        key[0] += W0;
+        key[1] += W1;
+    }
+    return counter;
+}
+
+RandomStream::RandomStream(Kind kind, std::uint64_t seed, std::uint32_t id)
+    : kind(kind), available(0), buffer{}, state{} {
+    if (kind == PHILOX) {
+        state = { seed, id, 0, 0 };
+    } else {
+        // Derive a distinct, well-mixed starting state for every (seed, id) pair
+        std::uint64_t x = splitMix64(seed) ^ (static_cast<std::uint64_t>(id) * 0xD1B54A32D192ED03ull);
+        for (auto& word : state) {
+            x = splitMix64(x);
+            word = x;
+        }
+    }
+}
+
+void RandomStream::refill() {
+    if (kind == PHILOX) {
+        std::uint64_t block = state[2]++;
+        buffer = philox4x32({ static_cast<std::uint32_t>(block), static_cast<std::uint32_t>(block >> 32),
+                              static_cast<std::uint32_t>(state[1]), 0 },
+                            { static_cast<std::uint32_t>(state[0]), static_cast<std::uint32_t>(state[0] >> 32) });
+    } else {
+        for (int half = 0; half < 2; ++half) {
+            std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+            std::uint64_t t = state[1] << 17;
+            state[2] ^= state[0];
+            state[3] ^= state[1];
+            state[1] ^= state[2];
+            state[0] ^= state[3];
+            state[2] ^= t;
+            state[3] = rotl(state[3], 45);
+            buffer[2 * half] = static_cast<std::uint32_t>(result);
+            buffer[2 * half + 1] = static_cast<std::uint32_t>(result >> 32);
+        }
+    }
+    available = 4;
+}
@@ -0,0 +1,65 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <array>
+#include <cstdint>
+
+// Philox4x32-10 counter-based generator: maps a 128-bit counter and a 64-bit key to
+// 128 random bits with no state, so any block of any stream can be computed directly.
+std::array<std::uint32_t, 4> philox4x32(std::array<std::uint32_t, 4> counter, std::array<std::uint32_t, 2> key);
+
+// SplitMix64 finalizer, used to derive independent seeds and to hash coordinates
+inline std::uint64_t splitMix64(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Independent random bit stream owned by a single particle.
+// Streams never share state, so each thread can advance its own particles without locks
+// and the bits a particle sees depend only on (seed, id) and how many it has consumed.
+class RandomStream {
+public:
+    enum Kind {
+        PHILOX,   // Philox4x32-10 keyed by the seed, with the particle id and block number as counter
+        XOSHIRO   // xoshiro256** seeded from (seed, id); faster, but not randomly addressable
+    };
+
+    RandomStream(Kind kind = PHILOX, std::uint64_t seed = 0, std::uint32_t id = 0);
+
+    // Next 32 random bits of this stream
+    std::uint32_t next() {
+        if (available == 0) {
+            refill();
+        }
+        return buffer[4 - available--];
+    }
+
+    Kind getKind() const { return kind; }
+
+private:
+    // Generate the next block of four words
+    void refill();
+
+    Kind kind;
+    std::uint8_t available;            // Words left in the buffer
+    std::array<std::uint32_t, 4> buffer;
+    std::array<std::uint64_t, 4> state; // Philox: seed, id, block counter; xoshiro: generator state
+};
+
+// Uniform integer in [0, bound) without modulo bias (Lemire's multiply-and-reject method)
+inline std::uint32_t uniformBelow(RandomStream& stream, std::uint32_t bound) {
+    std::uint64_t product = static_cast<std::uint64_t>(stream.next()) * bound;
+    std::uint32_t low = static_cast<std::uint32_t>(product);
+    if (low < bound) {
+        std::uint32_t threshold = (0u - bound) % bound;
+        while (low < threshold) {
+            product = static_cast<std::uint64_t>(stream.next()) * bound;
+            low = static_cast<std::uint32_t>(product);
+        }
+    }
+    return static_cast<std::uint32_t>(product >> 32);
+}
+
+#endif // RNG_H
@@ -0,0 +1,244 @@
+#include "swarm_simd.h"
+#include "maze.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SWARM_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// MOVE_TABLE widened to 32-bit entries so it can be gathered from
+struct WideMoveTable {
+    int entries[64];
+    WideMoveTable() : entries() {
+        for (int mask = 0; mask < 16; ++mask) {
+            for (int draw = 0; draw < 4; ++draw) {
+                entries[mask * 4 + draw] = MOVE_TABLE[mask][draw];
+            }
+        }
+    }
+};
+
+const WideMoveTable WIDE_MOVE_TABLE;
+
+// Refill the random bits of every lane in laneMask whose buffer is empty
+inline void refillLanes(const SwarmLanes& lanes, int first, unsigned laneMask) {
+    while (laneMask) {
+        int i = first + __builtin_ctz(laneMask);
+        laneMask &= laneMask - 1;
+        lanes.bits[i] = lanes.streams[i].next();
+        lanes.draws[i] = 16;
+    }
+}
+
+#ifdef SWARM_SIMD_X86
+
+__attribute__((target("avx2")))
+int stepAvx2(const std::uint8_t* cells, int stride, WalkMode mode, const SwarmLanes& lanes,
+             int first, int count, int steps, int& arrivalStep) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i allOnes = _mm256_set1_epi32(-1);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i three = _mm256_set1_epi32(3);
+    const __m256i sixteen = _mm256_set1_epi32(16);
+    const __m256i byteMask = _mm256_set1_epi32(0xFF);
+    const __m256i exitType = _mm256_set1_epi32(Maze::EXIT);
+    const __m256i stay = _mm256_set1_epi32(STAY);
+    const __m256i redraw = _mm256_set1_epi32(REDRAW);
+    const __m256i deltas = _mm256_setr_epi32(stride, -stride, 1, -1, 0, 0, 0, 0);
+    const int* grid = reinterpret_cast<const int*>(cells);
+    int winner = -1;
+
+    for (int i = first; i < first + count; i += 8) {
+        __m256i* positionsAt = reinterpret_cast<__m256i*>(lanes.positions + i);
+        __m256i* bitsAt = reinterpret_cast<__m256i*>(lanes.bits + i);
+        __m128i* drawsAt = reinterpret_cast<__m128i*>(lanes.draws + i);
+
+        __m256i pos = _mm256_loadu_si256(positionsAt);
+        __m256i bits = _mm256_loadu_si256(bitsAt);
+        __m256i left = _mm256_cvtepu8_epi32(_mm_loadl_epi64(drawsAt));
+        __m256i cur = _mm256_and_si256(_mm256_i32gather_epi32(grid, pos, 1), byteMask);
+
+        for (int step = 0; step < steps; ++step) {
+            __m256i mask = _mm256_srli_epi32(cur, MazeView::OPEN_SHIFT);
+
+            // Draw until every lane has a direction; lazy walks take the first draw
+            __m256i dir = zero;
+            __m256i pending = allOnes;
+            do {
+                __m256i empty = _mm256_and_si256(pending, _mm256_cmpeq_epi32(left, zero));
+                if (!_mm256_testz_si256(empty, empty)) {
+                    _mm256_storeu_si256(bitsAt, bits);
+                    refillLanes(lanes, i, static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(empty))));
+                    bits = _mm256_loadu_si256(bitsAt);
+                    left = _mm256_blendv_epi8(left, sixteen, empty);
+                }
+                __m256i draw = _mm256_and_si256(bits, three);
+                bits = _mm256_blendv_epi8(bits, _mm256_srli_epi32(bits, 2), pending);
+                left = _mm256_blendv_epi8(left, _mm256_sub_epi32(left, one), pending);
+
+                if (mode == WalkMode::LAZY) {
+                    dir = draw;
+                    break;
+                }
+                __m256i choice = _mm256_i32gather_epi32(WIDE_MOVE_TABLE.entries, _mm256_add_epi32(_mm256_slli_epi32(mask, 2), draw), 4);
+                dir = _mm256_blendv_epi8(dir, choice, pending);
+                pending = _mm256_and_si256(pending, _mm256_cmpeq_epi32(choice, redraw));
+            } while (!_mm256_testz_si256(pending, pending));
+
+            // STAY has a zero offset; it is excluded from the move mask below
+            __m256i next = _mm256_add_epi32(pos, _mm256_permutevar8x32_epi32(deltas, dir));
+            __m256i nextCell = _mm256_and_si256(_mm256_i32gather_epi32(grid, next, 1), byteMask);
+            __m256i type = _mm256_and_si256(nextCell, three);
+            __m256i moved = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpeq_epi32(type, zero), _mm256_cmpeq_epi32(dir, stay)), allOnes);
+            pos = _mm256_blendv_epi8(pos, next, moved);
+            cur = _mm256_blendv_epi8(cur, nextCell, moved);
+
+            unsigned arrived = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(
+                _mm256_and_si256(moved, _mm256_cmpeq_epi32(type, exitType)))));
+            if (arrived) {
+                // Later particles only matter if they arrive strictly earlier
+                winner = i + __builtin_ctz(arrived);
+                arrivalStep = step;
+                steps = step;
+                break;
+            }
+        }
+
+        _mm256_storeu_si256(positionsAt, pos);
+        _mm256_storeu_si256(bitsAt, bits);
+        __m128i left16 = _mm_packus_epi32(_mm256_castsi256_si128(left), _mm256_extracti128_si256(left, 1));
+        _mm_storel_epi64(drawsAt, _mm_packus_epi16(left16, left16));
+    }
+    return winner;
+}
+
+// GCC 12's AVX-512 headers trip -Wmaybe-uninitialized on their own placeholder registers
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+__attribute__((target("avx512f")))
+int stepAvx512(const std::uint8_t* cells, int stride, WalkMode mode, const SwarmLanes& lanes,
+               int first, int count, int steps, int& arrivalStep) {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i three = _mm512_set1_epi32(3);
+    const __m512i sixteen = _mm512_set1_epi32(16);
+    const __m512i byteMask = _mm512_set1_epi32(0xFF);
+    const __m512i exitType = _mm512_set1_epi32(Maze::EXIT);
+    const __m512i stay = _mm512_set1_epi32(STAY);
+    const __m512i redraw = _mm512_set1_epi32(REDRAW);
+    const __m512i deltas = _mm512_setr_epi32(stride, -stride, 1, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    int winner = -1;
+
+    for (int i = first; i < first + count; i += 16) {
+        __m128i* drawsAt = reinterpret_cast<__m128i*>(lanes.draws + i);
+
+        __m512i pos = _mm512_loadu_si512(lanes.positions + i);
+        __m512i bits = _mm512_loadu_si512(lanes.bits + i);
+        __m512i left = _mm512_cvtepu8_epi32(_mm_loadu_si128(drawsAt));
+        __m512i cur = _mm512_and_si512(_mm512_i32gather_epi32(pos, cells, 1), byteMask);
+
+        for (int step = 0; step < steps; ++step) {
+            __m512i mask = _mm512_srli_epi32(cur, MazeView::OPEN_SHIFT);
+
+            // Draw until every lane has a direction; lazy walks take the first draw
+            __m512i dir = zero;
+            __mmask16 pending = 0xFFFF;
+            do {
+                __mmask16 empty = _mm512_mask_cmpeq_epi32_mask(pending, left, zero);
+                if (empty) {
+                    _mm512_storeu_si512(lanes.bits + i, bits);
+                    refillLanes(lanes, i, empty);
+                    bits = _mm512_loadu_si512(lanes.bits + i);
+                    left = _mm512_mask_mov_epi32(left, empty, sixteen);
+                }
+                __m512i draw = _mm512_and_si512(bits, three);
+                bits = _mm512_mask_srli_epi32(bits, pending, bits, 2);
+                left = _mm512_mask_sub_epi32(left, pending, left, one);
+
+                if (mode == WalkMode::LAZY) {
+                    dir = draw;
+                    break;
+                }
+                __m512i choice = _mm512_i32gather_epi32(_mm512_add_epi32(_mm512_slli_epi32(mask, 2), draw), WIDE_MOVE_TABLE.entries, 4);
+                dir = _mm512_mask_mov_epi32(dir, pending, choice);
+                pending = _mm512_mask_cmpeq_epi32_mask(pending, choice, redraw);
+            } while (pending);
+
+            // STAY has a zero offset; it is excluded from the move mask below
+            __m512i next = _mm512_add_epi32(pos, _mm512_permutexvar_epi32(dir, deltas));
+            __m512i nextCell = _mm512_and_si512(_mm512_i32gather_epi32(next, cells, 1), byteMask);
+            __m512i type = _mm512_and_si512(nextCell, three);
+            __mmask16 moved = _mm512_cmpneq_epi32_mask(type, zero) & _mm512_cmpneq_epi32_mask(dir, stay);
+            pos = _mm512_mask_mov_epi32(pos, moved, next);
+            cur = _mm512_mask_mov_epi32(cur, moved, nextCell);
+
+            unsigned arrived = _mm512_mask_cmpeq_epi32_mask(moved, type, exitType);
+            if (arrived) {
+                // Later particles only matter if they arrive strictly earlier
+                winner = i + __builtin_ctz(arrived);
+                arrivalStep = step;
+                steps = step;
+                break;
+            }
+        }
+
+        _mm512_storeu_si512(lanes.positions + i, pos);
+        _mm512_storeu_si512(lanes.bits + i, bits);
+        _mm_storeu_si128(drawsAt, _mm512_cvtepi32_epi8(left));
+    }
+    return winner;
+}
+
+#pragma GCC diagnostic pop
+
+#endif // SWARM_SIMD_X86
+
+} // namespace
+
+SimdLevel detectSimdLevel() {
+#ifdef SWARM_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+#endif
+    return SimdLevel::SCALAR;
+}
+
+int simdWidth(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return 8;
+        case SimdLevel::AVX512: return 16;
+        default: return 1;
+    }
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::AVX512: return "AVX-512";
+        default: return "scalar";
+    }
+}
+
+int stepLanes(SimdLevel level, const std::uint8_t* cells, int stride, WalkMode mode,
+              const SwarmLanes& lanes, int first, int count, int steps, int& arrivalStep) {
+#ifdef SWARM_SIMD_X86
+    if (level == SimdLevel::AVX512) {
+        return stepAvx512(cells, stride, mode, lanes, first, count, steps, arrivalStep);
+    }
+    if (level == SimdLevel::AVX2) {
+        return stepAvx2(cells, stride, mode, lanes, first, count, steps, arrivalStep);
+    }
+#else
+    (void)level; (void)cells; (void)stride; (void)mode; (void)lanes;
+    (void)first; (void)count; (void)steps; (void)arrivalStep;
+#endif
+    return -1;
+}
@@ -0,0 +1,35 @@
+#ifndef SWARM_SIMD_H
+#define SWARM_SIMD_H
+
+#include <cstdint>
+#include "rng.h"
+#include "walk.h"
+
+// Instruction sets the swarm step kernel can be built for
+enum class SimdLevel { SCALAR, AVX2, AVX512 };
+
+// Best level supported by the running CPU
+SimdLevel detectSimdLevel();
+
+// Particles advanced per instruction at a given level
+int simdWidth(SimdLevel level);
+
+const char* simdLevelName(SimdLevel level);
+
+// Per-particle state the kernels read and write, laid out as in ParticleSwarm
+struct SwarmLanes {
+    int* positions;
+    std::uint32_t* bits;
+    std::uint8_t* draws;
+    RandomStream* streams;
+};
+
+// Advance particles [first, first + count) by up to `steps` steps each with the same semantics
+// as the scalar ParticleSwarm kernel; count must be a multiple of simdWidth(level).
+// Returns the particle that reached the exit first in round-robin order and sets arrivalStep
+// to the step it arrived on, or returns -1 if none did. Once an arrival is found, later
+// particles are only advanced far enough to tell whether they arrive strictly earlier.
+int stepLanes(SimdLevel level, const std::uint8_t* cells, int stride, WalkMode mode,
+              const SwarmLanes& lanes, int first, int count, int steps, int& arrivalStep);
+
+#endif // SWARM_SIMD_H
@@ -0,0 +1,162 @@
+#include "tiled_maze.h"
+#include "packed_maze.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+TiledMazeWriter::TiledMazeWriter(const std::string& path, int startX, int startY, int exitX, int exitY, std::uint64_t seed)
+    : path(path), file(nullptr), header(), tilesX(0), row(0) {
+    std::memcpy(header.magic, TiledMazeHeader::MAGIC, sizeof(header.magic));
+    header.version = TiledMazeHeader::VERSION;
+    header.tileSize = MAZE_TILE_SIZE;
+    header.startX = startX;
+    header.startY = startY;
+    header.exitX = exitX;
+    header.exitY = exitY;
+    header.seed = seed;
+}
+
+TiledMazeWriter::~TiledMazeWriter() {
+    if (file) {
+        std::fclose(file);
+    }
+}
+
+bool TiledMazeWriter::begin(int width, int height) {
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Unable to open file for writing: " << path << std::endl;
+        return false;
+    }
+
+    header.width = static_cast<std::uint32_t>(width);
+    header.height = static_cast<std::uint32_t>(height);
+    header.checksum = hashDimensions(width, height);
+    tilesX = (width + MAZE_TILE_SIZE - 1) / MAZE_TILE_SIZE;
+    row = 0;
+    packed.assign(tilesX * MAZE_TILE_ROW_BYTES, 0);
+    band.assign(tilesX * MAZE_TILE_BYTES, 0);
+
+    // The header is written again with the final checksum by end()
+    return std::fwrite(&header, sizeof(header), 1, file) == 1;
+}
+
+bool TiledMazeWriter::writeRow(const std::uint8_t* cells) {
+    header.checksum = fnv1a(header.checksum, cells, header.width);
+
+    // Each tile takes its slice of the packed row
+    packRow(cells, static_cast<int>(header.width), packed.data());
+    size_t offset = (row % MAZE_TILE_SIZE) * MAZE_TILE_ROW_BYTES;
+    for (int tile = 0; tile < tilesX; ++tile) {
+        std::memcpy(band.data() + tile * MAZE_TILE_BYTES + offset,
+                    packed.data() + tile * MAZE_TILE_ROW_BYTES, MAZE_TILE_ROW_BYTES);
+    }
+
+    ++row;
+    if (row % MAZE_TILE_SIZE != 0 && row != static_cast<int>(header.height)) {
+        return true;
+    }
+    bool ok = std::fwrite(band.data(), 1, band.size(), file) == band.size();
+    std::fill(band.begin(), band.end(), 0);  // Rows past the bottom edge stay walls
+    return ok;
+}
+
+bool TiledMazeWriter::end() {
+    bool ok = std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = std::fclose(file) == 0 && ok;
+    file = nullptr;
+    if (!ok) {
+        std::cerr << "Error writing maze file: " << path << std::endl;
+    }
+    return ok;
+}
+
+TiledMazeStore::TiledMazeStore(int cacheTiles)
+    : fd(-1), header(), width(0), height(0), tilesX(0), tilesY(0),
+      capacity(std::max(1, cacheTiles)), lastTile(-1), lastCells(nullptr) { }
+
+TiledMazeStore::~TiledMazeStore() {
+    close();
+}
+
+bool TiledMazeStore::open(const std::string& path) {
+    close();
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Unable to open file for reading: " << path << std::endl;
+        return false;
+    }
+
+    if (pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+        std::memcmp(header.magic, TiledMazeHeader::MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != TiledMazeHeader::VERSION || header.tileSize != MAZE_TILE_SIZE ||
+        header.width == 0 || header.height == 0 || header.width > INT32_MAX || header.height > INT32_MAX) {
+        std::cerr << "Invalid header in maze file: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    width = static_cast<int>(header.width);
+    height = static_cast<int>(header.height);
+    tilesX = (width + MAZE_TILE_SIZE - 1) / MAZE_TILE_SIZE;
+    tilesY = (height + MAZE_TILE_SIZE - 1) / MAZE_TILE_SIZE;
+
+    struct stat info;
+    std::uint64_t tileBytes = static_cast<std::uint64_t>(tilesX) * tilesY * MAZE_TILE_BYTES;
+    if (fstat(fd, &info) != 0 || static_cast<std::uint64_t>(info.st_size) < sizeof(TiledMazeHeader) + tileBytes) {
+        std::cerr << "Error reading maze data from file: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    slots.assign(capacity * MAZE_TILE_BYTES, 0);
+    cached.reserve(capacity);
+    return true;
+}
+
+void TiledMazeStore::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    recent.clear();
+    cached.clear();
+    lastTile = -1;
+    lastCells = nullptr;
+}
+
+const std::uint8_t* TiledMazeStore::tile(int index) const {
+    auto found = cached.find(index);
+    if (found != cached.end()) {
+        ++stats.hits;
+        recent.splice(recent.begin(), recent, found->second);
+    } else {
+        ++stats.faults;
+        int slot;
+        if (static_cast<int>(recent.size()) < capacity) {
+            slot = static_cast<int>(recent.size());
+        } else {
+            // Reuse the slot of the least recently used tile
+            slot = recent.back().second;
+            cached.erase(recent.back().first);
+            recent.pop_back();
+            ++stats.evictions;
+        }
+
+        std::uint8_t* cells = slots.data() + slot * MAZE_TILE_BYTES;
+        off_t offset = static_cast<off_t>(sizeof(TiledMazeHeader) + static_cast<std::uint64_t>(index) * MAZE_TILE_BYTES);
+        if (pread(fd, cells, MAZE_TILE_BYTES, offset) != static_cast<ssize_t>(MAZE_TILE_BYTES)) {
+            std::cerr << "Error reading maze tile " << index << " from file." << std::endl;
+            std::memset(cells, 0, MAZE_TILE_BYTES);  // Read as walls
+        }
+        recent.emplace_front(index, slot);
+        cached[index] = recent.begin();
+    }
+
+    lastTile = index;
+    lastCells = slots.data() + recent.front().second * MAZE_TILE_BYTES;
+    return lastCells;
+}
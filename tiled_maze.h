@@ -0,0 +1,137 @@
+#ifndef TILED_MAZE_H
+#define TILED_MAZE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "maze.h"
+#include "maze_stream.h"
+#include "walk.h"
+
+// Tiled maze format for mazes larger than memory: a fixed header followed by square tiles of
+// MAZE_TILE_SIZE x MAZE_TILE_SIZE cells in row-major tile order. Each tile holds its rows in
+// the packed 2-bit encoding of packed_maze.h; tiles on the right and bottom edges are padded
+// with walls, so every tile has the same size and offset arithmetic is trivial.
+constexpr int MAZE_TILE_SIZE = 256;
+constexpr size_t MAZE_TILE_ROW_BYTES = MAZE_TILE_SIZE / 4;
+constexpr size_t MAZE_TILE_BYTES = MAZE_TILE_ROW_BYTES * MAZE_TILE_SIZE;
+
+struct TiledMazeHeader {
+    static constexpr char MAGIC[4] = { 'R', 'M', 'Z', 'T' };
+    static constexpr std::uint32_t VERSION = 1;
+
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t tileSize;
+    std::int32_t startX, startY;  // -1 when unknown
+    std::int32_t exitX, exitY;    // -1 when unknown
+    std::uint32_t reserved;
+    std::uint64_t seed;           // 0 when unknown
+    std::uint64_t checksum;       // Content hash of the cells (see maze_stream.h)
+};
+
+static_assert(sizeof(TiledMazeHeader) == 56, "The tiled maze header must have no padding");
+
+// Writes rows as a tiled maze file, holding one band of tiles at a time
+class TiledMazeWriter : public MazeRowSink {
+public:
+    TiledMazeWriter(const std::string& path, int startX, int startY, int exitX, int exitY, std::uint64_t seed);
+    ~TiledMazeWriter() override;
+
+    bool begin(int width, int height) override;
+    bool writeRow(const std::uint8_t* cells) override;
+    bool end() override;
+
+private:
+    std::string path;
+    std::FILE* file;
+    TiledMazeHeader header;
+    int tilesX;
+    int row;                           // Rows written so far
+    std::vector<std::uint8_t> packed;  // One packed row, padded to whole tiles
+    std::vector<std::uint8_t> band;    // One row of tiles
+};
+
+// Counters of a tile cache
+struct TileCacheStats {
+    std::uint64_t hits = 0;       // Cell lookups served from a cached tile
+    std::uint64_t faults = 0;     // Tiles read from disk
+    std::uint64_t evictions = 0;  // Tiles dropped to make room
+
+    double hitRate() const { return hits + faults == 0 ? 0.0 : static_cast<double>(hits) / (hits + faults); }
+};
+
+// Read-through view of a tiled maze file with an LRU cache of tiles, queried the same way as
+// a MazeView. Lookups update the cache, so each thread needs its own store.
+class TiledMazeStore {
+public:
+    explicit TiledMazeStore(int cacheTiles = 1024);
+    ~TiledMazeStore();
+    TiledMazeStore(const TiledMazeStore&) = delete;
+    TiledMazeStore& operator=(const TiledMazeStore&) = delete;
+
+    // Open the file and check its header; reports problems on std::cerr
+    bool open(const std::string& path);
+    void close();
+
+    // Cell type at (x, y); everything outside the maze is a wall
+    std::uint8_t operator()(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width || y >= height) {
+            return Maze::WALL;
+        }
+        int index = (y / MAZE_TILE_SIZE) * tilesX + x / MAZE_TILE_SIZE;
+        const std::uint8_t* cells;
+        if (index == lastTile) {
+            ++stats.hits;  // Most moves stay in the tile of the previous lookup
+            cells = lastCells;
+        } else {
+            cells = tile(index);
+        }
+        int cx = x % MAZE_TILE_SIZE;
+        int cy = y % MAZE_TILE_SIZE;
+        return (cells[cy * MAZE_TILE_ROW_BYTES + cx / 4] >> ((cx % 4) * 2)) & 3;
+    }
+
+    // Open-neighbour mask at (x, y) (see walk.h for the direction order)
+    std::uint8_t openMask(int x, int y) const {
+        int mask = 0;
+        for (int dir = 0; dir < 4; ++dir) {
+            if ((*this)(x + DIRECTION_DX[dir], y + DIRECTION_DY[dir]) != Maze::WALL) {
+                mask |= 1 << dir;
+            }
+        }
+        return static_cast<std::uint8_t>(mask);
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    const TiledMazeHeader& getHeader() const { return header; }
+
+    const TileCacheStats& getStats() const { return stats; }
+    void resetStats() { stats = TileCacheStats(); }
+
+private:
+    // Cells of a tile, read from disk into the least recently used slot if it is not cached
+    const std::uint8_t* tile(int index) const;
+
+    int fd;
+    TiledMazeHeader header;
+    int width, height;
+    int tilesX, tilesY;
+    int capacity;                         // Tiles the cache holds
+
+    mutable std::vector<std::uint8_t> slots;               // capacity tiles
+    mutable std::list<std::pair<int, int>> recent;         // (tile, slot), most recent first
+    mutable std::unordered_map<int, std::list<std::pair<int, int>>::iterator> cached;
+    mutable int lastTile;                                  // Tile of the previous lookup
+    mutable const std::uint8_t* lastCells;
+    mutable TileCacheStats stats;
+};
+
+#endif // TILED_MAZE_H
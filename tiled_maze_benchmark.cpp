@@ -0,0 +1,90 @@
+#include "implicit_maze.h"
+#include "tiled_maze.h"
+#include "particle.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <iomanip>
+#include <fstream>
+
+// Particles on random lattice cells, so the walks spread over many tiles
+std::vector<Particle> makeParticles(int count, int size, std::uint64_t seed) {
+    RandomStream placement(RandomStream::XOSHIRO, seed);
+    std::uint32_t cells = static_cast<std::uint32_t>((size - 1) / 2);
+    std::vector<Particle> particles;
+    for (int i = 0; i < count; ++i) {
+        int x = 2 * static_cast<int>(uniformBelow(placement, cells)) + 1;
+        int y = 2 * static_cast<int>(uniformBelow(placement, cells)) + 1;
+        particles.emplace_back(x, y, RandomStream(RandomStream::PHILOX, seed, static_cast<std::uint32_t>(i)));
+    }
+    return particles;
+}
+
+// Move every particle once per round, like the sequential solver; returns the elapsed seconds
+template <typename Grid>
+double walk(const Grid& maze, std::vector<Particle>& particles, int rounds) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (auto& particle : particles) {
+            particle.move(maze, WalkMode::LEGAL);
+        }
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = endTime - startTime;
+    return elapsed.count();
+}
+
+int main() {
+    const int size = 8193;
+    const int particleCount = 1000;
+    const int rounds = 2000;
+    const std::uint64_t seed = 12345;
+    std::vector<int> cacheSizes = {16, 256, 4096};  // Tiles; the maze has 33 x 33 of them
+    const std::string path = "../input/tiled_" + std::to_string(size) + ".tiles";
+
+    // Write the maze to disk through the tiled writer
+    ImplicitMaze implicit(size, size, 1, 1, size - 2, size - 2, seed);
+    TiledMazeWriter writer(path, 1, 1, size - 2, size - 2, seed);
+    if (!implicit.generate(writer)) {
+        std::cerr << "Failed to write tiled maze: " << path << std::endl;
+        return 1;
+    }
+
+    // Reference walks on the implicit maze
+    std::vector<Particle> reference = makeParticles(particleCount, size, seed);
+    double referenceTime = walk(implicit, reference, rounds);
+    double moves = static_cast<double>(particleCount) * rounds;
+    std::cout << std::fixed << "implicit: " << std::setprecision(4) << referenceTime << " seconds, "
+              << std::setprecision(0) << moves / referenceTime << " moves/second" << std::endl;
+
+    std::ofstream csvFile("../output/tiled_maze_times.csv");
+    csvFile << "Cache tiles,Time (seconds),Moves per second,Hit rate,Tile faults,Evictions\n" << std::fixed;
+
+    for (int cacheTiles : cacheSizes) {
+        TiledMazeStore store(cacheTiles);
+        if (!store.open(path)) {
+            return 1;
+        }
+        std::vector<Particle> particles = makeParticles(particleCount, size, seed);
+        double elapsed = walk(store, particles, rounds);
+        const TileCacheStats& stats = store.getStats();
+
+        for (int i = 0; i < particleCount; ++i) {
+            if (particles[i].getX() != reference[i].getX() || particles[i].getY() != reference[i].getY()) {
+                std::cerr << "Tiled and implicit walks differ for particle " << i << std::endl;
+                break;
+            }
+        }
+
+        std::cout << "tiled, " << cacheTiles << " cached tiles: " << std::setprecision(4) << elapsed << " seconds, "
+                  << std::setprecision(0) << moves / elapsed << " moves/second, hit rate "
+                  << std::setprecision(4) << stats.hitRate() << ", " << stats.faults << " tile faults, "
+                  << stats.evictions << " evictions" << std::endl;
+        csvFile << cacheTiles << "," << std::setprecision(6) << elapsed << "," << std::setprecision(0) << moves / elapsed
+                << "," << std::setprecision(6) << stats.hitRate() << "," << stats.faults << "," << stats.evictions << "\n";
+    }
+
+    csvFile.close();
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include "trajectory.h"
+#include "walk.h"
+#include <algorithm>
+
+Trajectory::Trajectory() : startX(0), startY(0), cellCount(0) { }
+
+Trajectory::Trajectory(int startX, int startY) : startX(startX), startY(startY), cellCount(1) { }
+
+void Trajectory::truncate(std::size_t cells) {
+    if (cells >= cellCount) {
+        return;
+    }
+    cellCount = std::max<std::size_t>(cells, 1);
+
+    // Keep the words holding the remaining moves and clear the bits past the last one,
+    // since push() ORs new moves into the last word
+    std::size_t moves = cellCount - 1;
+    std::size_t words = (moves + MOVES_PER_WORD - 1) / MOVES_PER_WORD;
+    chunks.resize((words + CHUNK_WORDS - 1) / CHUNK_WORDS);
+    if (words % CHUNK_WORDS != 0) {
+        chunks.back().resize(words % CHUNK_WORDS);
+    }
+    if (moves % MOVES_PER_WORD != 0) {
+        chunks.back().back() &= (std::uint64_t(1) << (2 * (moves % MOVES_PER_WORD))) - 1;
+    }
+}
+
+int Trajectory::direction(std::size_t move) const {
+    std::size_t word = move / MOVES_PER_WORD;
+    std::uint64_t bits = chunks[word / CHUNK_WORDS][word % CHUNK_WORDS];
+    return static_cast<int>((bits >> (2 * (move % MOVES_PER_WORD))) & 3);
+}
+
+Trajectory::const_iterator::const_iterator(const Trajectory* trajectory, std::size_t index)
+    : trajectory(trajectory), index(index), cell(trajectory->startX, trajectory->startY) { }
+
+Trajectory::const_iterator& Trajectory::const_iterator::operator++() {
+    // Decode the move leading to the next cell, if there is one
+    if (++index < trajectory->cellCount) {
+        int dir = trajectory->direction(index - 1);
+        cell.first += DIRECTION_DX[dir];
+        cell.second += DIRECTION_DY[dir];
+    }
+    return *this;
+}
+
+Trajectory::const_iterator Trajectory::const_iterator::operator++(int) {
+    const_iterator previous = *this;
+    ++*this;
+    return previous;
+}
@@ -0,0 +1,78 @@
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility> // for std::pair
+#include <vector>
+
+// Compact record of a walk: the start cell followed by one 2-bit direction per move
+// (see walk.h for the direction order). Moves are packed 32 to a 64-bit word in chunks
+// of bounded size, so a long walk never reallocates more than one chunk at a time.
+class Trajectory {
+public:
+    // Forward iterator decoding the walk back to the coordinates of each visited cell
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<int, int>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        const_iterator(const Trajectory* trajectory, std::size_t index);
+
+        reference operator*() const { return cell; }
+        pointer operator->() const { return &cell; }
+        const_iterator& operator++();
+        const_iterator operator++(int);
+        bool operator==(const const_iterator& other) const { return index == other.index; }
+        bool operator!=(const const_iterator& other) const { return index != other.index; }
+
+    private:
+        const Trajectory* trajectory;
+        std::size_t index;           // Index of the current cell; cell i is reached by move i - 1
+        std::pair<int, int> cell;
+    };
+
+    Trajectory();
+    Trajectory(int startX, int startY);
+
+    // Append a move in the given direction
+    void push(int dir) {
+        std::size_t move = cellCount - 1;
+        if (move % MOVES_PER_WORD == 0) {
+            if (chunks.empty() || chunks.back().size() == CHUNK_WORDS) {
+                chunks.emplace_back();
+            }
+            chunks.back().push_back(0);
+        }
+        chunks.back().back() |= static_cast<std::uint64_t>(dir) << (2 * (move % MOVES_PER_WORD));
+        ++cellCount;
+    }
+
+    // Drop the moves after the first `cells` cells (at least the start cell is kept)
+    void truncate(std::size_t cells);
+
+    // Number of cells in the walk, including the start cell
+    std::size_t size() const { return cellCount; }
+    bool empty() const { return cellCount == 0; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, cellCount); }
+
+private:
+    static const std::size_t MOVES_PER_WORD = 32;
+    static const std::size_t CHUNK_WORDS = 1024;   // 32768 moves per chunk
+
+    // Direction of the given move
+    int direction(std::size_t move) const;
+
+    int startX;
+    int startY;
+    std::size_t cellCount;
+    std::vector<std::vector<std::uint64_t>> chunks;
+};
+
+#endif // TRAJECTORY_H
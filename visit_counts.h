@@ -0,0 +1,41 @@
+#ifndef VISIT_COUNTS_H
+#define VISIT_COUNTS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "maze.h"
+
+// Number of times each cell of a maze was entered, laid out like the padded MazeView grid
+// so a walker can count a visit at the linear index it already holds. Counts are 64-bit, so
+// even a million particles walking for days cannot wrap them.
+class VisitCounts {
+public:
+    VisitCounts() : width(0), height(0), stride(0) { }
+    explicit VisitCounts(const MazeView& maze)
+        : width(maze.getWidth()), height(maze.getHeight()), stride(maze.getStride()),
+          counts(static_cast<std::size_t>(maze.getStride()) * (maze.getHeight() + 2), 0) { }
+
+    // Count at interior coordinates
+    std::uint64_t operator()(int x, int y) const { return counts[static_cast<std::size_t>(y + 1) * stride + (x + 1)]; }
+
+    // Counts by linear index into the padded grid
+    std::uint64_t* data() { return counts.data(); }
+    const std::uint64_t* data() const { return counts.data(); }
+    std::size_t cellCount() const { return counts.size(); }
+
+    // Largest count of any cell
+    std::uint64_t max() const { return counts.empty() ? 0 : *std::max_element(counts.begin(), counts.end()); }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    bool empty() const { return counts.empty(); }
+
+private:
+    int width;
+    int height;
+    int stride;
+    std::vector<std::uint64_t> counts;
+};
+
+#endif // VISIT_COUNTS_H
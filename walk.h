@@ -0,0 +1,50 @@
+#ifndef WALK_H
+#define WALK_H
+
+#include <array>
+#include <cstdint>
+
+// How a particle picks its next move
+enum class WalkMode {
+    LAZY,   // Draw one of the four directions and stay put if it hits a wall
+    LEGAL   // Draw uniformly among the open neighbours of the current cell
+};
+
+// Directions are numbered down, up, right, left; bit d of an open mask is set when
+// the neighbour in direction d is not a wall
+constexpr int DIRECTION_DX[4] = { 0, 0, 1, -1 };
+constexpr int DIRECTION_DY[4] = { 1, -1, 0, 0 };
+
+// Pseudo-directions returned by MOVE_TABLE
+constexpr std::uint8_t STAY = 4;    // No open neighbour
+constexpr std::uint8_t REDRAW = 5;  // Draw again; keeps three-way choices uniform
+
+// MOVE_TABLE[mask][draw] maps an open mask and a two-bit draw to the direction taken
+using MoveTable = std::array<std::array<std::uint8_t, 4>, 16>;
+
+constexpr MoveTable makeMoveTable() {
+    MoveTable table{};
+    for (int mask = 0; mask < 16; ++mask) {
+        std::uint8_t open[4] = { 0, 0, 0, 0 };
+        int count = 0;
+        for (int dir = 0; dir < 4; ++dir) {
+            if (mask & (1 << dir)) {
+                open[count++] = static_cast<std::uint8_t>(dir);
+            }
+        }
+        for (int draw = 0; draw < 4; ++draw) {
+            if (count == 0) {
+                table[mask][draw] = STAY;
+            } else if (count == 3 && draw == 3) {
+                table[mask][draw] = REDRAW;
+            } else {
+                table[mask][draw] = open[draw % count];
+            }
+        }
+    }
+    return table;
+}
+
+constexpr MoveTable MOVE_TABLE = makeMoveTable();
+
+#endif // WALK_H